@@ -0,0 +1,262 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks of the generated bindings of the interfaces, dictionaries and
+// enumerations for testing in core/testing/, from script calls down to the
+// conversions of their arguments and return values.
+
+#include <iterator>
+#include <string>
+
+#include "base/timer/lap_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/blink/renderer/bindings/core/v8/idl_types.h"
+#include "third_party/blink/renderer/bindings/core/v8/native_value_traits_impl.h"
+#include "third_party/blink/renderer/bindings/core/v8/to_v8_traits.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_testing.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_dictionary_test.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_internal_dictionary.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_internal_enum.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_record_test.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_sequence_test.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_type_conversions.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_union_types_test.h"
+#include "third_party/blink/renderer/core/testing/dictionary_test.h"
+#include "third_party/blink/renderer/core/testing/record_test.h"
+#include "third_party/blink/renderer/core/testing/sequence_test.h"
+#include "third_party/blink/renderer/core/testing/type_conversions.h"
+#include "third_party/blink/renderer/core/testing/union_types_test.h"
+#include "third_party/blink/renderer/platform/bindings/exception_state.h"
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
+
+namespace blink {
+
+namespace {
+
+constexpr int kWarmupRuns = 10;
+constexpr base::TimeDelta kTimeLimit = base::Seconds(2);
+constexpr int kTimeCheckInterval = 10;
+
+// Number of calls that a script makes per lap.
+constexpr int kCallsPerLap = 1000;
+
+constexpr char kMetricPrefix[] = "GeneratedBindings.";
+constexpr char kMetricCallsPerSecond[] = "calls_per_second";
+constexpr char kMetricConversionsPerSecond[] = "conversions_per_second";
+
+// Runs |statement| |kCallsPerLap| times per lap in a script, where |target| is
+// the wrapper of |impl|, and reports the calls per second under |story|.
+// |setup| is run once before the measurement, in the same scope as
+// |statement|.
+template <typename T>
+void RunScriptCalls(const std::string& story,
+                    T* impl,
+                    const char* setup,
+                    const char* statement) {
+  V8TestingScope scope;
+  v8::Isolate* isolate = scope.GetIsolate();
+  v8::Local<v8::Context> context = scope.GetContext();
+  v8::Local<v8::Value> target =
+      ToV8Traits<T>::ToV8(scope.GetScriptState(), impl).ToLocalChecked();
+
+  const std::string source = std::string("(function() {") + setup +
+                             "; return function(target, count) {"
+                             " for (let i = 0; i < count; ++i) { " +
+                             statement + "; } }; })()";
+  v8::Local<v8::Function> function =
+      v8::Script::Compile(context, V8String(isolate, source.c_str()))
+          .ToLocalChecked()
+          ->Run(context)
+          .ToLocalChecked()
+          .As<v8::Function>();
+  v8::Local<v8::Value> args[] = {target,
+                                 v8::Integer::New(isolate, kCallsPerLap)};
+
+  perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+  reporter.RegisterImportantMetric(kMetricCallsPerSecond, "calls/s");
+
+  base::LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+  do {
+    v8::TryCatch try_catch(isolate);
+    ASSERT_FALSE(function->Call(context, context->Global(), std::size(args),
+                                args)
+                     .IsEmpty());
+    timer.NextLap();
+  } while (!timer.HasTimeLimitExpired());
+  reporter.AddResult(kMetricCallsPerSecond,
+                     timer.LapsPerSecond() * kCallsPerLap);
+}
+
+// Runs |convert| repeatedly and reports the conversions per second under
+// |story|.
+template <typename Function>
+void RunConversions(const std::string& story,
+                    V8TestingScope& scope,
+                    Function convert) {
+  perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+  reporter.RegisterImportantMetric(kMetricConversionsPerSecond,
+                                   "conversions/s");
+
+  base::LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+  do {
+    v8::HandleScope handle_scope(scope.GetIsolate());
+    convert();
+    timer.NextLap();
+  } while (!timer.HasTimeLimitExpired());
+  reporter.AddResult(kMetricConversionsPerSecond, timer.LapsPerSecond());
+}
+
+// The same dictionary as CreateInternalDictionary() creates.
+constexpr char kDictionarySetup[] =
+    "const value = {longMember: 42, stringMember: 'member', enumMember: 'bar', "
+    "stringSequenceMember: ['a', 'b', 'c', 'd']}";
+
+InternalDictionary* CreateInternalDictionary() {
+  InternalDictionary* dictionary = InternalDictionary::Create();
+  dictionary->setLongMember(42);
+  dictionary->setStringMember("member");
+  dictionary->setEnumMember(V8InternalEnum(V8InternalEnum::Enum::kBar));
+  dictionary->setStringSequenceMember(Vector<String>({"a", "b", "c", "d"}));
+  return dictionary;
+}
+
+TEST(GeneratedBindingsPerfTest, AttributeGetLong) {
+  RunScriptCalls("attribute_get_long",
+                 MakeGarbageCollected<TypeConversions>(), "",
+                 "target.testLong");
+}
+
+TEST(GeneratedBindingsPerfTest, AttributeSetLong) {
+  RunScriptCalls("attribute_set_long",
+                 MakeGarbageCollected<TypeConversions>(), "",
+                 "target.testLong = i");
+}
+
+TEST(GeneratedBindingsPerfTest, AttributeGetString) {
+  RunScriptCalls("attribute_get_usv_string",
+                 MakeGarbageCollected<TypeConversions>(),
+                 "", "target.testUSVString");
+}
+
+TEST(GeneratedBindingsPerfTest, AttributeSetString) {
+  RunScriptCalls("attribute_set_usv_string",
+                 MakeGarbageCollected<TypeConversions>(),
+                 "const value = 'abcdefghijklmnopqrstuvwxyz'",
+                 "target.testUSVString = value");
+}
+
+TEST(GeneratedBindingsPerfTest, AttributeSetUnion) {
+  RunScriptCalls("attribute_set_union",
+                 MakeGarbageCollected<UnionTypesTest>(), "",
+                 "target.doubleOrStringOrStringSequenceAttribute = i");
+}
+
+TEST(GeneratedBindingsPerfTest, OperationDoubleArgument) {
+  RunScriptCalls("operation_double_argument",
+                 MakeGarbageCollected<UnionTypesTest>(), "",
+                 "target.doubleOrStringArg(i + 0.5)");
+}
+
+TEST(GeneratedBindingsPerfTest, OperationStringArgument) {
+  RunScriptCalls("operation_string_argument",
+                 MakeGarbageCollected<UnionTypesTest>(),
+                 "const value = 'abcdefghijklmnopqrstuvwxyz'",
+                 "target.doubleOrStringArg(value)");
+}
+
+TEST(GeneratedBindingsPerfTest, OperationEnumArgument) {
+  RunScriptCalls("operation_enum_argument",
+                 MakeGarbageCollected<UnionTypesTest>(), "",
+                 "target.doubleOrInternalEnumArg('baz')");
+}
+
+TEST(GeneratedBindingsPerfTest, OperationSequenceArgument) {
+  RunScriptCalls("operation_sequence_argument",
+                 MakeGarbageCollected<SequenceTest>(),
+                 "const value = Array.from({length: 100}, (_, i) => i)",
+                 "target.identityLongSequence(value)");
+}
+
+TEST(GeneratedBindingsPerfTest, OperationRecordArgument) {
+  RunScriptCalls("operation_record_argument",
+                 MakeGarbageCollected<RecordTest>(),
+                 "const value = Object.fromEntries("
+                 "Array.from({length: 20}, (_, i) => ['key' + i, i]))",
+                 "target.setStringLongRecord(value)");
+}
+
+TEST(GeneratedBindingsPerfTest, OperationDictionaryArgument) {
+  RunScriptCalls("operation_dictionary_argument",
+                 MakeGarbageCollected<DictionaryTest>(),
+                 kDictionarySetup,
+                 "target.set(value)");
+}
+
+TEST(GeneratedBindingsPerfTest, ToV8Dictionary) {
+  V8TestingScope scope;
+  ScriptState* script_state = scope.GetScriptState();
+  InternalDictionary* dictionary = CreateInternalDictionary();
+  RunConversions("to_v8_dictionary", scope, [&]() {
+    ASSERT_FALSE(ToV8Traits<InternalDictionary>::ToV8(script_state, dictionary)
+                     .IsEmpty());
+  });
+}
+
+TEST(GeneratedBindingsPerfTest, ToV8SequenceOfLong) {
+  V8TestingScope scope;
+  ScriptState* script_state = scope.GetScriptState();
+  Vector<int32_t> sequence;
+  for (int32_t i = 0; i < 1000; ++i)
+    sequence.push_back(i);
+  RunConversions("to_v8_sequence_of_long_1000", scope, [&]() {
+    ASSERT_FALSE(
+        ToV8Traits<IDLSequence<IDLLong>>::ToV8(script_state, sequence)
+            .IsEmpty());
+  });
+}
+
+TEST(GeneratedBindingsPerfTest, ToV8SequenceOfString) {
+  V8TestingScope scope;
+  ScriptState* script_state = scope.GetScriptState();
+  Vector<String> sequence;
+  for (int i = 0; i < 1000; ++i)
+    sequence.push_back("value" + String::Number(i));
+  RunConversions("to_v8_sequence_of_string_1000", scope, [&]() {
+    ASSERT_FALSE(
+        ToV8Traits<IDLSequence<IDLString>>::ToV8(script_state, sequence)
+            .IsEmpty());
+  });
+}
+
+TEST(GeneratedBindingsPerfTest, ToV8SequenceOfDictionary) {
+  V8TestingScope scope;
+  ScriptState* script_state = scope.GetScriptState();
+  HeapVector<Member<InternalDictionary>> sequence;
+  for (int i = 0; i < 100; ++i)
+    sequence.push_back(CreateInternalDictionary());
+  RunConversions("to_v8_sequence_of_dictionary_100", scope, [&]() {
+    ASSERT_FALSE(ToV8Traits<IDLSequence<InternalDictionary>>::ToV8(
+                     script_state, sequence)
+                     .IsEmpty());
+  });
+}
+
+TEST(GeneratedBindingsPerfTest, EnumFromV8) {
+  V8TestingScope scope;
+  v8::Isolate* isolate = scope.GetIsolate();
+  v8::Local<v8::Value> value = V8String(isolate, "baz");
+  RunConversions("enum_from_v8", scope, [&]() {
+    NonThrowableExceptionState exception_state;
+    EXPECT_EQ(NativeValueTraits<V8InternalEnum>::NativeValue(isolate, value,
+                                                             exception_state)
+                  .AsEnum(),
+              V8InternalEnum::Enum::kBaz);
+  });
+}
+
+}  // namespace
+
+}  // namespace blink
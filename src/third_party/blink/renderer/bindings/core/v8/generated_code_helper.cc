@@ -4,6 +4,8 @@
 
 #include "third_party/blink/renderer/bindings/core/v8/generated_code_helper.h"
 
+#include <algorithm>
+
 #include "third_party/blink/renderer/bindings/core/v8/native_value_traits_impl.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_core.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_css_style_declaration.h"
@@ -178,6 +180,99 @@ absl::optional<size_t> FindIndexInEnumStringTable(
   return absl::nullopt;
 }
 
+namespace {
+
+template <typename CharType>
+absl::optional<size_t> FindIndexInEnumStringLookupTable(
+    const CharType* chars,
+    size_t length,
+    const EnumStringLookupTable& lookup_table) {
+  if (length + 1 >= lookup_table.length_offsets.size())
+    return absl::nullopt;
+  const uint16_t begin = lookup_table.length_offsets[length];
+  const uint16_t end = lookup_table.length_offsets[length + 1];
+  for (uint16_t i = begin; i < end; ++i) {
+    const EnumStringLookupTable::Entry& entry = lookup_table.entries[i];
+    // The entries of the same length are sorted, so the scan can stop as soon
+    // as the first character goes past.
+    if (length && static_cast<LChar>(entry.value[0]) > chars[0])
+      break;
+    if (std::equal(chars, chars + length, entry.value,
+                   [](CharType lhs, char rhs) {
+                     return lhs == static_cast<LChar>(rhs);
+                   })) {
+      return entry.index;
+    }
+  }
+  return absl::nullopt;
+}
+
+absl::optional<size_t> FindIndexInEnumStringLookupTable(
+    v8::Isolate* isolate,
+    v8::Local<v8::String> value,
+    const EnumStringLookupTable& lookup_table) {
+  const int length = value->Length();
+  if (static_cast<size_t>(length) + 1 >= lookup_table.length_offsets.size())
+    return absl::nullopt;
+  // Enum values are short, so the characters almost always fit in the inline
+  // buffers.
+  if (value->IsOneByte()) {
+    Vector<LChar, 64> buffer(length);
+    value->WriteOneByte(isolate, buffer.data(), 0, length,
+                        v8::String::NO_NULL_TERMINATION);
+    return FindIndexInEnumStringLookupTable(buffer.data(), length,
+                                            lookup_table);
+  }
+  Vector<UChar, 64> buffer(length);
+  value->Write(isolate, reinterpret_cast<uint16_t*>(buffer.data()), 0, length,
+               v8::String::NO_NULL_TERMINATION);
+  return FindIndexInEnumStringLookupTable(buffer.data(), length, lookup_table);
+}
+
+}  // namespace
+
+absl::optional<size_t> FindIndexInEnumStringTable(
+    v8::Isolate* isolate,
+    v8::Local<v8::Value> value,
+    const EnumStringLookupTable& lookup_table,
+    const char* enum_type_name,
+    ExceptionState& exception_state) {
+  if (LIKELY(value->IsString())) {
+    absl::optional<size_t> index = FindIndexInEnumStringLookupTable(
+        isolate, value.As<v8::String>(), lookup_table);
+    if (LIKELY(index.has_value()))
+      return index;
+  }
+
+  const String& str_value = NativeValueTraits<IDLString>::NativeValue(
+      isolate, value, exception_state);
+  if (UNLIKELY(exception_state.HadException()))
+    return absl::nullopt;
+
+  absl::optional<size_t> index =
+      FindIndexInEnumStringTable(str_value, lookup_table);
+
+  if (UNLIKELY(!index.has_value())) {
+    exception_state.ThrowTypeError("The provided value '" + str_value +
+                                   "' is not a valid enum value of type " +
+                                   enum_type_name + ".");
+  }
+  return index;
+}
+
+absl::optional<size_t> FindIndexInEnumStringTable(
+    const String& str_value,
+    const EnumStringLookupTable& lookup_table) {
+  if (str_value.IsNull())
+    return absl::nullopt;
+  if (str_value.Is8Bit()) {
+    return FindIndexInEnumStringLookupTable(
+        str_value.Characters8(), str_value.length(), lookup_table);
+  }
+  return FindIndexInEnumStringLookupTable(str_value.Characters16(),
+                                          str_value.length(), lookup_table);
+}
+
 void ReportInvalidEnumSetToAttribute(v8::Isolate* isolate,
                                      const String& value,
                                      const String& enum_type_name,
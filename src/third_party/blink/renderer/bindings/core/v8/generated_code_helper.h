@@ -137,6 +137,38 @@ CORE_EXPORT absl::optional<size_t> FindIndexInEnumStringTable(
     const String& str_value,
     base::span<const char* const> enum_value_table);
 
+// Lookup table of the values of an IDL enumeration, generated by
+// bind_gen/enumeration.py.  The entries are sorted by the length of the values
+// and then by the values themselves, and the entries in the range
+// [length_offsets[n], length_offsets[n + 1]) are the values of length n, so
+// that a lookup only compares the strings of the same length.  The values are
+// ASCII, so that their lengths and characters are the same in UTF-8, Latin-1
+// and UTF-16.
+struct EnumStringLookupTable {
+  struct Entry {
+    const char* value;
+    // Index of |value| in the enumeration's string table.
+    size_t index;
+  };
+
+  base::span<const Entry> entries;
+  base::span<const uint16_t> length_offsets;
+};
+
+// Same as above, but looks up the index by using |lookup_table|.  A string
+// |value| is compared directly against the table without creating a
+// blink::String unless it is not a valid enum value.
+CORE_EXPORT absl::optional<size_t> FindIndexInEnumStringTable(
+    v8::Isolate* isolate,
+    v8::Local<v8::Value> value,
+    const EnumStringLookupTable& lookup_table,
+    const char* enum_type_name,
+    ExceptionState& exception_state);
+
+CORE_EXPORT absl::optional<size_t> FindIndexInEnumStringTable(
+    const String& str_value,
+    const EnumStringLookupTable& lookup_table);
+
 CORE_EXPORT void ReportInvalidEnumSetToAttribute(
     v8::Isolate* isolate,
     const String& value,
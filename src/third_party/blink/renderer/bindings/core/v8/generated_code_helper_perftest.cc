@@ -0,0 +1,134 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/bindings/core/v8/generated_code_helper.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/timer/lap_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_testing.h"
+#include "third_party/blink/renderer/platform/bindings/exception_state.h"
+
+namespace blink {
+
+namespace {
+
+constexpr int kWarmupRuns = 10;
+constexpr base::TimeDelta kTimeLimit = base::Seconds(2);
+constexpr int kTimeCheckInterval = 10;
+
+constexpr char kMetricPrefix[] = "EnumStringLookup.";
+constexpr char kMetricLookupsPerSecond[] = "lookups_per_second";
+
+// An enumeration with |size| values of various lengths, along with the string
+// table and the lookup table in the same shape as bind_gen/enumeration.py
+// generates.
+class TestEnumeration {
+ public:
+  explicit TestEnumeration(size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      values_.push_back(std::string(1 + i % 7, 'a' + i % 26) + "-" +
+                        std::to_string(i));
+    }
+    for (const std::string& value : values_)
+      string_table_.push_back(value.c_str());
+
+    std::vector<size_t> sorted(size);
+    for (size_t i = 0; i < size; ++i)
+      sorted[i] = i;
+    std::sort(sorted.begin(), sorted.end(), [this](size_t lhs, size_t rhs) {
+      return std::make_pair(values_[lhs].size(), values_[lhs]) <
+             std::make_pair(values_[rhs].size(), values_[rhs]);
+    });
+    for (size_t index : sorted)
+      entries_.push_back({string_table_[index], index});
+    size_t offset = 0;
+    for (size_t length = 0; length <= values_[sorted.back()].size() + 1;
+         ++length) {
+      while (offset < size && values_[sorted[offset]].size() < length)
+        ++offset;
+      length_offsets_.push_back(static_cast<uint16_t>(offset));
+    }
+    lookup_table_ = {entries_, length_offsets_};
+  }
+
+  const std::vector<std::string>& values() const { return values_; }
+  base::span<const char* const> string_table() const { return string_table_; }
+  const bindings::EnumStringLookupTable& lookup_table() const {
+    return lookup_table_;
+  }
+
+ private:
+  std::vector<std::string> values_;
+  std::vector<const char*> string_table_;
+  std::vector<bindings::EnumStringLookupTable::Entry> entries_;
+  std::vector<uint16_t> length_offsets_;
+  bindings::EnumStringLookupTable lookup_table_;
+};
+
+// Looks up every value of an enumeration of |size| values, both with the
+// lookup table and with the linear scan of the string table.
+void RunEnumLookup(size_t size) {
+  V8TestingScope scope;
+  v8::Isolate* isolate = scope.GetIsolate();
+  TestEnumeration enumeration(size);
+  Vector<v8::Local<v8::Value>> v8_values;
+  for (const std::string& value : enumeration.values())
+    v8_values.push_back(V8String(isolate, value.c_str()));
+
+  perf_test::PerfResultReporter reporter(kMetricPrefix,
+                                         std::to_string(size) + "_values");
+  reporter.RegisterImportantMetric(kMetricLookupsPerSecond, "lookups/s");
+  reporter.RegisterImportantMetric(
+      "_string_table." + std::string(kMetricLookupsPerSecond), "lookups/s");
+
+  {
+    base::LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+    do {
+      for (wtf_size_t i = 0; i < v8_values.size(); ++i) {
+        NonThrowableExceptionState exception_state;
+        ASSERT_EQ(i, bindings::FindIndexInEnumStringTable(
+                         isolate, v8_values[i], enumeration.lookup_table(),
+                         "TestEnumeration", exception_state));
+      }
+      timer.NextLap();
+    } while (!timer.HasTimeLimitExpired());
+    reporter.AddResult(kMetricLookupsPerSecond,
+                       timer.LapsPerSecond() * v8_values.size());
+  }
+  {
+    base::LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+    do {
+      for (wtf_size_t i = 0; i < v8_values.size(); ++i) {
+        NonThrowableExceptionState exception_state;
+        ASSERT_EQ(i, bindings::FindIndexInEnumStringTable(
+                         isolate, v8_values[i], enumeration.string_table(),
+                         "TestEnumeration", exception_state));
+      }
+      timer.NextLap();
+    } while (!timer.HasTimeLimitExpired());
+    reporter.AddResult("_string_table." + std::string(kMetricLookupsPerSecond),
+                       timer.LapsPerSecond() * v8_values.size());
+  }
+}
+
+TEST(GeneratedCodeHelperPerfTest, EnumLookup1) {
+  RunEnumLookup(1);
+}
+
+TEST(GeneratedCodeHelperPerfTest, EnumLookup10) {
+  RunEnumLookup(10);
+}
+
+TEST(GeneratedCodeHelperPerfTest, EnumLookup50) {
+  RunEnumLookup(50);
+}
+
+}  // namespace
+
+}  // namespace blink
@@ -0,0 +1,137 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/bindings/core/v8/generated_code_helper.h"
+
+#include <iterator>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_testing.h"
+#include "third_party/blink/renderer/platform/bindings/exception_state.h"
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+
+namespace blink {
+
+namespace {
+
+// The tables of an enumeration { "pending", "", "playing", "paused", "idle" }
+// in the same shape as bind_gen/enumeration.py generates.
+constexpr const char* const kStringTable[] = {"pending", "", "playing",
+                                              "paused", "idle"};
+
+constexpr bindings::EnumStringLookupTable::Entry kLookupEntries[] = {
+    {"", 1}, {"idle", 4}, {"paused", 3}, {"pending", 0}, {"playing", 2}};
+
+constexpr uint16_t kLookupLengthOffsets[] = {0, 1, 1, 1, 1, 2, 2, 3, 5};
+
+constexpr bindings::EnumStringLookupTable kLookupTable = {
+    kLookupEntries, kLookupLengthOffsets};
+
+absl::optional<size_t> FindIndex(V8TestingScope& scope,
+                                 v8::Local<v8::Value> value,
+                                 ExceptionState& exception_state) {
+  return bindings::FindIndexInEnumStringTable(scope.GetIsolate(), value,
+                                              kLookupTable, "TestEnum",
+                                              exception_state);
+}
+
+TEST(GeneratedCodeHelperTest, FindIndexInEnumStringLookupTable) {
+  V8TestingScope scope;
+  for (size_t i = 0; i < std::size(kStringTable); ++i) {
+    NonThrowableExceptionState exception_state;
+    EXPECT_EQ(i, FindIndex(scope, V8String(scope.GetIsolate(), kStringTable[i]),
+                           exception_state));
+    EXPECT_EQ(i, bindings::FindIndexInEnumStringTable(String(kStringTable[i]),
+                                                      kLookupTable));
+  }
+}
+
+TEST(GeneratedCodeHelperTest, FindIndexInEnumStringLookupTableTwoByte) {
+  V8TestingScope scope;
+  for (size_t i = 0; i < std::size(kStringTable); ++i) {
+    String value(kStringTable[i]);
+    value.Ensure16Bit();
+    ASSERT_FALSE(value.Is8Bit());
+    NonThrowableExceptionState exception_state;
+    EXPECT_EQ(i, FindIndex(scope, V8String(scope.GetIsolate(), value),
+                           exception_state));
+    EXPECT_EQ(i, bindings::FindIndexInEnumStringTable(value, kLookupTable));
+  }
+
+  // A two-byte string which has the same length and the same first character
+  // as a valid value.
+  const UChar kNotAValue[] = {'p', 'a', 'u', 's', 0x00E9, 'd'};
+  String value(kNotAValue, std::size(kNotAValue));
+  EXPECT_FALSE(bindings::FindIndexInEnumStringTable(value, kLookupTable));
+  DummyExceptionStateForTesting exception_state;
+  EXPECT_FALSE(FindIndex(scope, V8String(scope.GetIsolate(), value),
+                         exception_state));
+  EXPECT_TRUE(exception_state.HadException());
+}
+
+TEST(GeneratedCodeHelperTest, FindIndexInEnumStringLookupTableNoMatch) {
+  V8TestingScope scope;
+  // Values of the same length as, and starting with the same character as,
+  // valid values, and values of lengths that no value has.
+  const char* const kNotValues[] = {"pendinG", "plainly", "pausee", "idl",
+                                    "i",       "idles",   "playing!"};
+  for (const char* value : kNotValues) {
+    EXPECT_FALSE(
+        bindings::FindIndexInEnumStringTable(String(value), kLookupTable))
+        << value;
+    DummyExceptionStateForTesting exception_state;
+    EXPECT_FALSE(FindIndex(scope, V8String(scope.GetIsolate(), value),
+                           exception_state))
+        << value;
+    EXPECT_TRUE(exception_state.HadException()) << value;
+  }
+  EXPECT_FALSE(bindings::FindIndexInEnumStringTable(String(), kLookupTable));
+}
+
+TEST(GeneratedCodeHelperTest, FindIndexInEnumStringLookupTableEmptyString) {
+  V8TestingScope scope;
+  NonThrowableExceptionState exception_state;
+  EXPECT_EQ(1u, FindIndex(scope, v8::String::Empty(scope.GetIsolate()),
+                          exception_state));
+  EXPECT_EQ(1u, bindings::FindIndexInEnumStringTable(g_empty_string,
+                                                     kLookupTable));
+}
+
+TEST(GeneratedCodeHelperTest, FindIndexInEnumStringLookupTableInvalidValue) {
+  V8TestingScope scope;
+  {
+    DummyExceptionStateForTesting exception_state;
+    EXPECT_FALSE(FindIndex(scope, V8String(scope.GetIsolate(), "stopped"),
+                           exception_state));
+    EXPECT_TRUE(exception_state.HadException());
+    EXPECT_EQ(
+        "The provided value 'stopped' is not a valid enum value of type "
+        "TestEnum.",
+        exception_state.Message());
+  }
+  {
+    // A non-string value is converted to a string first.
+    DummyExceptionStateForTesting exception_state;
+    EXPECT_FALSE(FindIndex(scope, v8::Number::New(scope.GetIsolate(), 42),
+                           exception_state));
+    EXPECT_EQ(
+        "The provided value '42' is not a valid enum value of type TestEnum.",
+        exception_state.Message());
+  }
+  {
+    // The error message is the same as the one of the string table.
+    DummyExceptionStateForTesting exception_state;
+    EXPECT_FALSE(bindings::FindIndexInEnumStringTable(
+        scope.GetIsolate(), V8String(scope.GetIsolate(), "stopped"),
+        kStringTable, "TestEnum", exception_state));
+    EXPECT_EQ(
+        "The provided value 'stopped' is not a valid enum value of type "
+        "TestEnum.",
+        exception_state.Message());
+  }
+}
+
+}  // namespace
+
+}  // namespace blink
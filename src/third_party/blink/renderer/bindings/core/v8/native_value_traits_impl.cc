@@ -39,31 +39,20 @@ void NativeValueTraitsInterfaceNotOfType(
       argument_index, wrapper_type_info->interface_name));
 }
 
-template <>
-CORE_TEMPLATE_EXPORT typename NativeValueTraits<IDLSequence<IDLLong>>::ImplType
-CreateIDLSequenceFromV8Array<IDLLong>(v8::Isolate* isolate,
-                                      v8::Local<v8::Array> v8_array,
-                                      ExceptionState& exception_state) {
-  typename NativeValueTraits<IDLSequence<IDLLong>>::ImplType result;
-
-  // https://webidl.spec.whatwg.org/#create-sequence-from-iterable
-  const uint32_t length = v8_array->Length();
-  if (length >
-      NativeValueTraits<IDLSequence<IDLLong>>::ImplType::MaxCapacity()) {
-    exception_state.ThrowRangeError("Array length exceeds supported limit.");
-    return {};
-  }
-
-  result.ReserveInitialCapacity(length);
-  result.resize(length);
-  if (v8::TryCopyAndConvertArrayToCppBuffer<&v8::kTypeInfoInt32, int32_t>(
-          v8_array, result.data(), length)) {
-    return result;
-  }
+bool TryCopyV8ArrayToDoubleBuffer(v8::Local<v8::Array> v8_array,
+                                  double* buffer,
+                                  uint32_t length) {
+  // Smis are widened and doubles are copied as is, so no precision is lost
+  // for any of the IDL numeric types.
+  return v8::TryCopyAndConvertArrayToCppBuffer<&v8::kTypeInfoFloat64, double>(
+      v8_array, buffer, length);
+}
 
-  // Slow path
-  return bindings::CreateIDLSequenceFromV8ArraySlow<IDLLong>(isolate, v8_array,
-                                                             exception_state);
+bool TryCopyV8ArrayToInt32Buffer(v8::Local<v8::Array> v8_array,
+                                 int32_t* buffer,
+                                 uint32_t length) {
+  return v8::TryCopyAndConvertArrayToCppBuffer<&v8::kTypeInfoInt32, int32_t>(
+      v8_array, buffer, length);
 }
 
 }  // namespace bindings
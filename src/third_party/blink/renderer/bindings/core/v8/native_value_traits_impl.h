@@ -5,6 +5,11 @@
 #ifndef THIRD_PARTY_BLINK_RENDERER_BINDINGS_CORE_V8_NATIVE_VALUE_TRAITS_IMPL_H_
 #define THIRD_PARTY_BLINK_RENDERER_BINDINGS_CORE_V8_NATIVE_VALUE_TRAITS_IMPL_H_
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/renderer/bindings/core/v8/idl_types.h"
 #include "third_party/blink/renderer/bindings/core/v8/native_value_traits.h"
@@ -903,23 +908,171 @@ CreateIDLSequenceFromV8ArraySlow(v8::Isolate* isolate,
   return result;
 }
 
-// Fastest case: template-specialized implementation that directly copies the
-// contents of this JavaScript array into a C++ buffer.
+// Copies the elements of |v8_array| into |buffer| as doubles if the array has
+// packed Smi or double elements and its iteration has no observable effects,
+// i.e. no element access can run script or reach the prototype chain. Returns
+// false otherwise. |buffer| must have room for |length| elements, which must
+// be the current length of |v8_array|.
+CORE_EXPORT bool TryCopyV8ArrayToDoubleBuffer(v8::Local<v8::Array> v8_array,
+                                              double* buffer,
+                                              uint32_t length);
+
+// Same as TryCopyV8ArrayToDoubleBuffer, but V8 converts double elements with
+// ToInt32, which is the conversion of an IDL long in the default mode.
+CORE_EXPORT bool TryCopyV8ArrayToInt32Buffer(v8::Local<v8::Array> v8_array,
+                                             int32_t* buffer,
+                                             uint32_t length);
+
+// NumericSequenceBulkConverter<T> converts a buffer of doubles, copied out of
+// a JavaScript array by TryCopyV8ArrayToDoubleBuffer, into the elements of a
+// sequence<T> in one pass.  Convert() returns false if any element needs the
+// full conversion steps (wrapping, clamping, rounding or throwing), in which
+// case the caller falls back to CreateIDLSequenceFromV8ArraySlow so that both
+// the result and the exception message are exactly the per-element ones.
+//
+// The loops are written without early exits so that they can be vectorized.
+template <typename T>
+struct NumericSequenceBulkConverter {
+  static constexpr bool kIsSupported = false;
+};
+
+template <typename T, IDLIntegerConvMode mode>
+struct NumericSequenceBulkConverter<IDLIntegerTypeBase<T, mode>> {
+  static constexpr bool kIsSupported = true;
+
+  static bool Convert(const double* src, T* dst, wtf_size_t length) {
+    // An integral value within [kMin, kMax] converts to itself in all of the
+    // default, [Clamp] and [EnforceRange] modes.  The range is capped at the
+    // safe integer range so that 64-bit types are exact, too.
+    constexpr double kMaxSafeInteger = 9007199254740991.0;  // 2^53 - 1
+    constexpr double kMin = std::max(
+        static_cast<double>(std::numeric_limits<T>::min()), -kMaxSafeInteger);
+    constexpr double kMax = std::min(
+        static_cast<double>(std::numeric_limits<T>::max()), kMaxSafeInteger);
+    bool is_exact = true;
+    for (wtf_size_t i = 0; i < length; ++i) {
+      const double value = src[i];
+      // NaN fails all of the comparisons.
+      is_exact &=
+          (value >= kMin) & (value <= kMax) & (std::trunc(value) == value);
+    }
+    if (!is_exact)
+      return false;
+    for (wtf_size_t i = 0; i < length; ++i)
+      dst[i] = static_cast<T>(src[i]);
+    return true;
+  }
+};
+
+template <IDLFloatingPointNumberConvMode mode>
+struct NumericSequenceBulkConverter<
+    IDLFloatingPointNumberTypeBase<double, mode>> {
+  static constexpr bool kIsSupported = true;
+
+  // |src| and |dst| may be the same buffer.
+  static bool Convert(const double* src, double* dst, wtf_size_t length) {
+    if constexpr (mode == IDLFloatingPointNumberConvMode::kDefault) {
+      // |value - value| is NaN for NaN and +/-Infinity, and 0 otherwise.
+      bool is_finite = true;
+      for (wtf_size_t i = 0; i < length; ++i)
+        is_finite &= (src[i] - src[i] == 0.0);
+      if (!is_finite)
+        return false;
+    }
+    if (src != dst)
+      std::copy_n(src, length, dst);
+    return true;
+  }
+};
+
+template <IDLFloatingPointNumberConvMode mode>
+struct NumericSequenceBulkConverter<
+    IDLFloatingPointNumberTypeBase<float, mode>> {
+  static constexpr bool kIsSupported = true;
+
+  static bool Convert(const double* src, float* dst, wtf_size_t length) {
+    // Same as ToFloat(): values beyond the float range become +/-Infinity.
+    using Limits = std::numeric_limits<float>;
+    for (wtf_size_t i = 0; i < length; ++i) {
+      const double value = src[i];
+      dst[i] = value > Limits::max()      ? Limits::infinity()
+               : value < Limits::lowest() ? -Limits::infinity()
+                                          : static_cast<float>(value);
+    }
+    if constexpr (mode == IDLFloatingPointNumberConvMode::kDefault) {
+      // Same as ToRestrictedFloat(): the check is made after the conversion.
+      bool is_finite = true;
+      for (wtf_size_t i = 0; i < length; ++i)
+        is_finite &= (dst[i] - dst[i] == 0.0f);
+      if (!is_finite)
+        return false;
+    }
+    return true;
+  }
+};
+
+// Fastest case: bulk-copies the contents of a JavaScript array of numbers into
+// a C++ buffer and converts them all at once.  Falls back to the slow case
+// if the array has holes, non-number elements or accessors, or if any element
+// needs the full conversion steps.
+//
+// sequence<long> and sequence<double> are copied straight into the result.
+// The other types are copied into a buffer of doubles first, from which they
+// are range checked and narrowed.
 template <typename T>
 typename NativeValueTraits<IDLSequence<T>>::ImplType
-CreateIDLSequenceFromV8Array(v8::Isolate* isolate,
-                             v8::Local<v8::Array> v8_array,
-                             ExceptionState& exception_state) {
+CreateIDLSequenceFromV8NumberArray(v8::Isolate* isolate,
+                                   v8::Local<v8::Array> v8_array,
+                                   ExceptionState& exception_state) {
+  using ImplType = typename NativeValueTraits<IDLSequence<T>>::ImplType;
+  using ElementType = typename ImplType::ValueType;
+
+  // https://webidl.spec.whatwg.org/#create-sequence-from-iterable
+  const uint32_t length = v8_array->Length();
+  if (length > ImplType::MaxCapacity()) {
+    exception_state.ThrowRangeError("Array length exceeds supported limit.");
+    return {};
+  }
+
+  ImplType result;
+  result.ReserveInitialCapacity(length);
+  result.resize(length);
+  if constexpr (std::is_same_v<T, IDLLong>) {
+    if (TryCopyV8ArrayToInt32Buffer(v8_array, result.data(), length))
+      return result;
+  } else if constexpr (std::is_same_v<ElementType, double>) {
+    if (TryCopyV8ArrayToDoubleBuffer(v8_array, result.data(), length) &&
+        NumericSequenceBulkConverter<T>::Convert(result.data(), result.data(),
+                                                 length)) {
+      return result;
+    }
+  } else {
+    Vector<double> buffer(length);
+    if (TryCopyV8ArrayToDoubleBuffer(v8_array, buffer.data(), length) &&
+        NumericSequenceBulkConverter<T>::Convert(buffer.data(), result.data(),
+                                                 length)) {
+      return result;
+    }
+  }
+
+  // Slow path
   return CreateIDLSequenceFromV8ArraySlow<T>(isolate, v8_array,
                                              exception_state);
 }
 
-template <>
-CORE_EXTERN_TEMPLATE_EXPORT
-    typename NativeValueTraits<IDLSequence<IDLLong>>::ImplType
-    CreateIDLSequenceFromV8Array<IDLLong>(v8::Isolate* isolate,
-                                          v8::Local<v8::Array> v8_array,
-                                          ExceptionState& exception_state);
+template <typename T>
+typename NativeValueTraits<IDLSequence<T>>::ImplType
+CreateIDLSequenceFromV8Array(v8::Isolate* isolate,
+                             v8::Local<v8::Array> v8_array,
+                             ExceptionState& exception_state) {
+  if constexpr (NumericSequenceBulkConverter<T>::kIsSupported) {
+    return CreateIDLSequenceFromV8NumberArray<T>(isolate, v8_array,
+                                                 exception_state);
+  } else {
+    return CreateIDLSequenceFromV8ArraySlow<T>(isolate, v8_array,
+                                               exception_state);
+  }
+}
 
 }  // namespace bindings
 
@@ -0,0 +1,112 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/bindings/core/v8/native_value_traits_impl.h"
+
+#include "base/timer/lap_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/blink/renderer/bindings/core/v8/idl_types.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_testing.h"
+#include "third_party/blink/renderer/platform/bindings/exception_state.h"
+
+namespace blink {
+
+namespace {
+
+constexpr int kWarmupRuns = 10;
+constexpr base::TimeDelta kTimeLimit = base::Seconds(2);
+constexpr int kTimeCheckInterval = 10;
+
+constexpr char kMetricPrefix[] = "NativeValueTraitsSequence.";
+constexpr char kMetricElementsPerSecond[] = "elements_per_second";
+
+v8::Local<v8::Array> EvaluateScriptForArray(V8TestingScope& scope,
+                                            const char* source) {
+  v8::Local<v8::Script> script =
+      v8::Script::Compile(scope.GetContext(),
+                          V8String(scope.GetIsolate(), source))
+          .ToLocalChecked();
+  return script->Run(scope.GetContext()).ToLocalChecked().As<v8::Array>();
+}
+
+// Measures the conversion of the array created by |source| into a sequence<T>
+// through NativeValueTraits (the bulk path when applicable) and through the
+// per-element slow path, and reports both under |story|.
+template <typename T>
+void RunSequenceConversion(const std::string& story, const char* source) {
+  V8TestingScope scope;
+  v8::Isolate* isolate = scope.GetIsolate();
+  v8::Local<v8::Array> v8_array = EvaluateScriptForArray(scope, source);
+  const uint32_t length = v8_array->Length();
+
+  perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+  reporter.RegisterImportantMetric(kMetricElementsPerSecond, "elements/s");
+  reporter.RegisterImportantMetric("_slow_path." +
+                                       std::string(kMetricElementsPerSecond),
+                                   "elements/s");
+
+  {
+    base::LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+    do {
+      NonThrowableExceptionState exception_state;
+      auto&& sequence = NativeValueTraits<IDLSequence<T>>::NativeValue(
+          isolate, v8_array, exception_state);
+      ASSERT_EQ(length, sequence.size());
+      timer.NextLap();
+    } while (!timer.HasTimeLimitExpired());
+    reporter.AddResult(kMetricElementsPerSecond,
+                       timer.LapsPerSecond() * length);
+  }
+  {
+    base::LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+    do {
+      NonThrowableExceptionState exception_state;
+      auto&& sequence = bindings::CreateIDLSequenceFromV8ArraySlow<T>(
+          isolate, v8_array, exception_state);
+      ASSERT_EQ(length, sequence.size());
+      timer.NextLap();
+    } while (!timer.HasTimeLimitExpired());
+    reporter.AddResult("_slow_path." + std::string(kMetricElementsPerSecond),
+                       timer.LapsPerSecond() * length);
+  }
+}
+
+constexpr char kSmiArray[] = "Array.from({length: 100000}, (_, i) => i & 0xff)";
+constexpr char kDoubleArray[] =
+    "Array.from({length: 100000}, (_, i) => i + 0.5)";
+
+TEST(NativeValueTraitsImplPerfTest, SequenceOfLong) {
+  RunSequenceConversion<IDLLong>("long", kSmiArray);
+}
+
+TEST(NativeValueTraitsImplPerfTest, SequenceOfUnsignedLong) {
+  RunSequenceConversion<IDLUnsignedLong>("unsigned_long", kSmiArray);
+}
+
+TEST(NativeValueTraitsImplPerfTest, SequenceOfOctetClamp) {
+  RunSequenceConversion<IDLOctetClamp>("octet_clamp", kSmiArray);
+}
+
+TEST(NativeValueTraitsImplPerfTest, SequenceOfShortEnforceRange) {
+  RunSequenceConversion<IDLShortEnforceRange>("short_enforce_range",
+                                              kSmiArray);
+}
+
+TEST(NativeValueTraitsImplPerfTest, SequenceOfDouble) {
+  RunSequenceConversion<IDLDouble>("double", kDoubleArray);
+}
+
+TEST(NativeValueTraitsImplPerfTest, SequenceOfUnrestrictedDouble) {
+  RunSequenceConversion<IDLUnrestrictedDouble>("unrestricted_double",
+                                               kDoubleArray);
+}
+
+TEST(NativeValueTraitsImplPerfTest, SequenceOfFloat) {
+  RunSequenceConversion<IDLFloat>("float", kDoubleArray);
+}
+
+}  // namespace
+
+}  // namespace blink
@@ -323,6 +323,126 @@ TEST(NativeValueTraitsImplTest, IDLSequence) {
   }
 }
 
+TEST(NativeValueTraitsImplTest, IDLSequenceOfNumbersFastPath) {
+  V8TestingScope scope;
+  {
+    // Packed Smi elements.
+    v8::Local<v8::Array> v8_array =
+        EvaluateScriptForArray(scope, "[0, 1, -2, 255, 256]");
+    NonThrowableExceptionState exception_state;
+    EXPECT_EQ(Vector<int16_t>({0, 1, -2, 255, 256}),
+              NativeValueTraits<IDLSequence<IDLShort>>::NativeValue(
+                  scope.GetIsolate(), v8_array, exception_state));
+    EXPECT_EQ(Vector<double>({0, 1, -2, 255, 256}),
+              NativeValueTraits<IDLSequence<IDLDouble>>::NativeValue(
+                  scope.GetIsolate(), v8_array, exception_state));
+    // Out of range elements take the per-element conversion steps.
+    EXPECT_EQ(Vector<uint8_t>({0, 1, 254, 255, 0}),
+              NativeValueTraits<IDLSequence<IDLOctet>>::NativeValue(
+                  scope.GetIsolate(), v8_array, exception_state));
+    EXPECT_EQ(Vector<uint8_t>({0, 1, 0, 255, 255}),
+              NativeValueTraits<IDLSequence<IDLOctetClamp>>::NativeValue(
+                  scope.GetIsolate(), v8_array, exception_state));
+  }
+  {
+    // Packed double elements.
+    v8::Local<v8::Array> v8_array =
+        EvaluateScriptForArray(scope, "[0.5, 1, 2.5, -3.5, 4294967296]");
+    NonThrowableExceptionState exception_state;
+    EXPECT_EQ(
+        Vector<double>({0.5, 1, 2.5, -3.5, 4294967296}),
+        NativeValueTraits<IDLSequence<IDLUnrestrictedDouble>>::NativeValue(
+            scope.GetIsolate(), v8_array, exception_state));
+    EXPECT_EQ(Vector<float>({0.5f, 1.0f, 2.5f, -3.5f, 4294967296.0f}),
+              NativeValueTraits<IDLSequence<IDLFloat>>::NativeValue(
+                  scope.GetIsolate(), v8_array, exception_state));
+    EXPECT_EQ(Vector<int32_t>({0, 1, 2, -3, 0}),
+              NativeValueTraits<IDLSequence<IDLLong>>::NativeValue(
+                  scope.GetIsolate(), v8_array, exception_state));
+    EXPECT_EQ(Vector<uint64_t>({0, 1, 2, 18446744073709551613ull, 4294967296}),
+              NativeValueTraits<IDLSequence<IDLUnsignedLongLong>>::NativeValue(
+                  scope.GetIsolate(), v8_array, exception_state));
+  }
+  {
+    // sequence<long> is copied by V8, which wraps doubles as ToInt32 does.
+    v8::Local<v8::Array> v8_array = EvaluateScriptForArray(
+        scope, "[4294967297.5, -2147483649, NaN, Infinity, -0]");
+    NonThrowableExceptionState exception_state;
+    EXPECT_EQ(Vector<int32_t>({1, 2147483647, 0, 0, 0}),
+              NativeValueTraits<IDLSequence<IDLLong>>::NativeValue(
+                  scope.GetIsolate(), v8_array, exception_state));
+  }
+  {
+    v8::Local<v8::Array> v8_array =
+        EvaluateScriptForArray(scope, "[-1e10, 1.0, 1e10]");
+    NonThrowableExceptionState exception_state;
+    EXPECT_EQ(Vector<int32_t>({-2147483648, 1, 2147483647}),
+              NativeValueTraits<IDLSequence<IDLLongClamp>>::NativeValue(
+                  scope.GetIsolate(), v8_array, exception_state));
+  }
+  {
+    v8::Local<v8::Array> v8_array =
+        EvaluateScriptForArray(scope, "[1, 2, 65536]");
+    DummyExceptionStateForTesting exception_state;
+    const auto& sequence =
+        NativeValueTraits<IDLSequence<IDLUnsignedShortEnforceRange>>::
+            NativeValue(scope.GetIsolate(), v8_array, exception_state);
+    EXPECT_TRUE(exception_state.HadException());
+    EXPECT_EQ("Value is outside the 'unsigned short' value range.",
+              exception_state.Message());
+    EXPECT_TRUE(sequence.IsEmpty());
+  }
+  {
+    v8::Local<v8::Array> v8_array =
+        EvaluateScriptForArray(scope, "[1, 2, NaN]");
+    DummyExceptionStateForTesting exception_state;
+    const auto& sequence =
+        NativeValueTraits<IDLSequence<IDLDouble>>::NativeValue(
+            scope.GetIsolate(), v8_array, exception_state);
+    EXPECT_TRUE(exception_state.HadException());
+    EXPECT_TRUE(sequence.IsEmpty());
+  }
+  {
+    v8::Local<v8::Array> v8_array =
+        EvaluateScriptForArray(scope, "[1, 1e300]");
+    DummyExceptionStateForTesting exception_state;
+    const auto& sequence =
+        NativeValueTraits<IDLSequence<IDLFloat>>::NativeValue(
+            scope.GetIsolate(), v8_array, exception_state);
+    EXPECT_TRUE(exception_state.HadException());
+    EXPECT_EQ("The provided float value is non-finite.",
+              exception_state.Message());
+    EXPECT_TRUE(sequence.IsEmpty());
+  }
+  {
+    // Holes are looked up on the prototype chain.
+    v8::Local<v8::Array> v8_array =
+        EvaluateScriptForArray(scope,
+                               "Array.prototype[1] = 7;"
+                               "let arr = [1, , 3];"
+                               "arr");
+    NonThrowableExceptionState exception_state;
+    EXPECT_EQ(Vector<int32_t>({1, 7, 3}),
+              NativeValueTraits<IDLSequence<IDLLong>>::NativeValue(
+                  scope.GetIsolate(), v8_array, exception_state));
+    EvaluateScriptForObject(scope, "delete Array.prototype[1]; arr");
+  }
+  {
+    // Getters run in order and may change the length of the array.
+    v8::Local<v8::Array> v8_array =
+        EvaluateScriptForArray(scope,
+                               "let arr2 = [1, 2, 3];"
+                               "Object.defineProperty(arr2, 1, {"
+                               "  get() { arr2.length = 2; return 5; }"
+                               "});"
+                               "arr2");
+    NonThrowableExceptionState exception_state;
+    EXPECT_EQ(Vector<double>({1, 5}),
+              NativeValueTraits<IDLSequence<IDLDouble>>::NativeValue(
+                  scope.GetIsolate(), v8_array, exception_state));
+  }
+}
+
 }  // namespace
 
 }  // namespace blink
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "third_party/blink/renderer/bindings/core/v8/profiler_trace_builder.h"
+
 #include "base/time/time.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_profiler_frame.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_profiler_marker.h"
@@ -10,6 +11,7 @@
 #include "third_party/blink/renderer/bindings/core/v8/v8_profiler_stack.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_profiler_trace.h"
 #include "third_party/blink/renderer/core/timing/performance.h"
+#include "third_party/blink/renderer/platform/heap/collection_support/heap_vector.h"
 #include "third_party/blink/renderer/platform/instrumentation/tracing/trace_event.h"
 #include "third_party/blink/renderer/platform/weborigin/kurl.h"
 #include "third_party/blink/renderer/platform/wtf/vector.h"
@@ -17,6 +19,60 @@
 
 namespace blink {
 
+namespace {
+
+constexpr wtf_size_t kUnused = std::numeric_limits<wtf_size_t>::max();
+
+// Given |new_ids| where the unused entries are kUnused, assigns consecutive
+// IDs to the other entries in the order of their current IDs.
+void AssignNewIds(Vector<wtf_size_t>& new_ids) {
+  wtf_size_t next_id = 0;
+  for (wtf_size_t& id : new_ids) {
+    if (id != kUnused)
+      id = next_id++;
+  }
+}
+
+// The keys of the stack and the frame tables.  The IDs plus one, where kNoId
+// + 1 wraps around to 0, so that a key is never the empty value of the hash
+// table.
+uint64_t StackKey(wtf_size_t parent_stack_id, wtf_size_t frame_id) {
+  return static_cast<uint64_t>(static_cast<wtf_size_t>(parent_stack_id + 1))
+             << 32 |
+         (static_cast<uint64_t>(frame_id) + 1);
+}
+
+std::pair<uint64_t, uint64_t> FrameKey(wtf_size_t function_name_id,
+                                       wtf_size_t resource_id,
+                                       int line,
+                                       int column) {
+  return std::pair<uint64_t, uint64_t>(
+      (static_cast<uint64_t>(function_name_id) + 1) << 32 |
+          static_cast<wtf_size_t>(resource_id + 1),
+      static_cast<uint64_t>(static_cast<uint32_t>(line)) << 32 |
+          static_cast<uint32_t>(column));
+}
+
+// Keeps the strings which have new IDs, and re-interns them.
+void CompactStrings(const Vector<wtf_size_t>& new_ids,
+                    Vector<String>& strings,
+                    HashMap<String, wtf_size_t>& string_ids) {
+  string_ids.clear();
+  wtf_size_t size = 0;
+  for (wtf_size_t i = 0; i < strings.size(); ++i) {
+    if (new_ids[i] == kUnused)
+      continue;
+    DCHECK_EQ(new_ids[i], size);
+    if (size != i)
+      strings[size] = std::move(strings[i]);
+    string_ids.insert(strings[size], size);
+    ++size;
+  }
+  strings.Shrink(size);
+}
+
+}  // namespace
+
 ProfilerTrace* ProfilerTraceBuilder::FromProfile(
     ScriptState* script_state,
     const v8::CpuProfile* profile,
@@ -25,36 +81,40 @@ ProfilerTrace* ProfilerTraceBuilder::FromProfile(
   TRACE_EVENT0("blink", "ProfilerTraceBuilder::FromProfile");
   ProfilerTraceBuilder* builder = MakeGarbageCollected<ProfilerTraceBuilder>(
       script_state, allowed_origin, time_origin);
-  if (profile) {
-    for (int i = 0; i < profile->GetSamplesCount(); i++) {
-      const auto* node = profile->GetSample(i);
-      auto timestamp = base::TimeTicks() +
-                       base::Microseconds(profile->GetSampleTimestamp(i));
-      const auto state = profile->GetSampleState(i);
-      builder->AddSample(node, timestamp, state);
-    }
-  }
+  builder->AddProfile(profile);
   return builder->GetTrace();
 }
 
 ProfilerTraceBuilder::ProfilerTraceBuilder(ScriptState* script_state,
                                            const SecurityOrigin* allowed_origin,
-                                           base::TimeTicks time_origin)
+                                           base::TimeTicks time_origin,
+                                           wtf_size_t max_samples)
     : script_state_(script_state),
       allowed_origin_(allowed_origin),
-      time_origin_(time_origin) {}
+      time_origin_(time_origin),
+      max_samples_(max_samples) {}
 
 void ProfilerTraceBuilder::Trace(Visitor* visitor) const {
   visitor->Trace(script_state_);
-  visitor->Trace(frames_);
-  visitor->Trace(stacks_);
-  visitor->Trace(samples_);
+}
+
+void ProfilerTraceBuilder::AddProfile(const v8::CpuProfile* profile) {
+  TRACE_EVENT0("blink", "ProfilerTraceBuilder::AddProfile");
+  if (!profile)
+    return;
+  for (int i = 0; i < profile->GetSamplesCount(); i++) {
+    const auto* node = profile->GetSample(i);
+    auto timestamp = base::TimeTicks() +
+                     base::Microseconds(profile->GetSampleTimestamp(i));
+    const auto state = profile->GetSampleState(i);
+    AddSample(node, timestamp, state);
+  }
+  node_to_stack_map_.clear();
 }
 
 void ProfilerTraceBuilder::AddSample(const v8::CpuProfileNode* node,
                                      base::TimeTicks timestamp,
                                      const v8::StateTag state) {
-  auto* sample = ProfilerSample::Create();
   // TODO(yoav): This should not use MonotonicTimeToDOMHighResTimeStamp, as
   // these timestamps are clamped, which makes no sense for traces. Since this
   // only exposes time to traces, it's fine to define this as statically "cross
@@ -62,24 +122,34 @@ void ProfilerTraceBuilder::AddSample(const v8::CpuProfileNode* node,
   auto relative_timestamp = Performance::MonotonicTimeToDOMHighResTimeStamp(
       time_origin_, timestamp, /*allow_negative_value=*/true,
       /*cross_origin_isolated_capability=*/true);
+  wtf_size_t stack_id = GetOrInsertStackId(node);
+  uint8_t marker = 0;
+  if (absl::optional<blink::V8ProfilerMarker> v8_marker =
+          VMStateToMarker(state)) {
+    marker = static_cast<uint8_t>(v8_marker->AsEnum()) + 1;
+  }
 
-  sample->setTimestamp(relative_timestamp);
-  if (absl::optional<wtf_size_t> stack_id = GetOrInsertStackId(node))
-    sample->setStackId(*stack_id);
-
-  if (absl::optional<blink::V8ProfilerMarker> marker = VMStateToMarker(state))
-    sample->setMarker(*marker);
-
-  samples_.push_back(sample);
+  if (max_samples_ && sample_timestamps_.size() == max_samples_) {
+    // Overwrite the oldest sample.
+    sample_timestamps_[first_sample_index_] = relative_timestamp;
+    sample_stack_ids_[first_sample_index_] = stack_id;
+    sample_markers_[first_sample_index_] = marker;
+    first_sample_index_ = (first_sample_index_ + 1) % max_samples_;
+    // Every sample has been replaced since the last roll-over, so are many of
+    // the stacks, frames and strings that they refer to.
+    if (!first_sample_index_)
+      Compact();
+    return;
+  }
+  sample_timestamps_.push_back(relative_timestamp);
+  sample_stack_ids_.push_back(stack_id);
+  sample_markers_.push_back(marker);
 }
 
-absl::optional<wtf_size_t> ProfilerTraceBuilder::GetOrInsertStackId(
+wtf_size_t ProfilerTraceBuilder::GetOrInsertStackId(
     const v8::CpuProfileNode* node) {
   if (!node)
-    return absl::optional<wtf_size_t>();
-
-  if (!ShouldIncludeStackFrame(node))
-    return GetOrInsertStackId(node->GetParent());
+    return kNoId;
 
   auto existing_stack_id = node_to_stack_map_.find(node);
   if (existing_stack_id != node_to_stack_map_.end()) {
@@ -88,67 +158,224 @@ absl::optional<wtf_size_t> ProfilerTraceBuilder::GetOrInsertStackId(
     return existing_stack_id->value;
   }
 
-  auto* stack = ProfilerStack::Create();
-  wtf_size_t frame_id = GetOrInsertFrameId(node);
-  stack->setFrameId(frame_id);
-  if (absl::optional<int> parent_stack_id =
-          GetOrInsertStackId(node->GetParent()))
-    stack->setParentId(*parent_stack_id);
-
-  wtf_size_t stack_id = stacks_.size();
-  stacks_.push_back(stack);
+  // An omitted frame is coalesced into the stack of its parent.
+  wtf_size_t stack_id = GetOrInsertStackId(node->GetParent());
+  if (ShouldIncludeStackFrame(node)) {
+    const wtf_size_t parent_stack_id = stack_id;
+    const wtf_size_t frame_id = GetOrInsertFrameId(node);
+    auto result = stack_ids_.insert(StackKey(parent_stack_id, frame_id),
+                                    stack_parent_ids_.size());
+    if (result.is_new_entry) {
+      stack_parent_ids_.push_back(parent_stack_id);
+      stack_frame_ids_.push_back(frame_id);
+    }
+    stack_id = result.stored_value->value;
+  }
   node_to_stack_map_.Set(node, stack_id);
   return stack_id;
 }
 
 wtf_size_t ProfilerTraceBuilder::GetOrInsertFrameId(
     const v8::CpuProfileNode* node) {
-  auto existing_frame_id = node_to_frame_map_.find(node);
-
-  if (existing_frame_id != node_to_frame_map_.end())
-    return existing_frame_id->value;
-
-  auto* frame = ProfilerFrame::Create();
-  frame->setName(node->GetFunctionNameStr());
+  const wtf_size_t function_name_id = GetOrInsertStringId(
+      node->GetFunctionNameStr(), function_names_, function_name_ids_);
+  wtf_size_t resource_id = kNoId;
   if (*node->GetScriptResourceNameStr() != '\0') {
-    wtf_size_t resource_id =
-        GetOrInsertResourceId(node->GetScriptResourceNameStr());
-    frame->setResourceId(resource_id);
+    resource_id = GetOrInsertStringId(node->GetScriptResourceNameStr(),
+                                      resources_, resource_ids_);
   }
-  if (node->GetLineNumber() != v8::CpuProfileNode::kNoLineNumberInfo)
-    frame->setLine(node->GetLineNumber());
-  if (node->GetColumnNumber() != v8::CpuProfileNode::kNoColumnNumberInfo)
-    frame->setColumn(node->GetColumnNumber());
-
-  wtf_size_t frame_id = frames_.size();
-  frames_.push_back(frame);
-  node_to_frame_map_.Set(node, frame_id);
+  const int line = node->GetLineNumber();
+  const int column = node->GetColumnNumber();
+
+  auto result =
+      frame_ids_.insert(FrameKey(function_name_id, resource_id, line, column),
+                        frame_function_name_ids_.size());
+  if (result.is_new_entry) {
+    frame_function_name_ids_.push_back(function_name_id);
+    frame_resource_ids_.push_back(resource_id);
+    frame_lines_.push_back(line);
+    frame_columns_.push_back(column);
+  }
+  return result.stored_value->value;
+}
 
-  return frame_id;
+// static
+wtf_size_t ProfilerTraceBuilder::GetOrInsertStringId(
+    const char* string,
+    Vector<String>& strings,
+    HashMap<String, wtf_size_t>& string_ids) {
+  String value(string);
+  auto result = string_ids.insert(value, strings.size());
+  if (result.is_new_entry)
+    strings.push_back(value);
+  return result.stored_value->value;
 }
 
-wtf_size_t ProfilerTraceBuilder::GetOrInsertResourceId(
-    const char* resource_name) {
-  // Since V8's CPU profiler already does string interning, pointer equality is
-  // value equality here.
-  auto existing_resource_id = resource_map_.find(resource_name);
+ProfilerTraceBuilder::NewIds ProfilerTraceBuilder::ComputeNewIds() const {
+  NewIds new_ids{Vector<wtf_size_t>(stack_parent_ids_.size(), kUnused),
+                 Vector<wtf_size_t>(frame_function_name_ids_.size(), kUnused),
+                 Vector<wtf_size_t>(function_names_.size(), kUnused),
+                 Vector<wtf_size_t>(resources_.size(), kUnused)};
+  for (wtf_size_t stack_id : sample_stack_ids_) {
+    while (stack_id != kNoId && new_ids.stack_ids[stack_id] == kUnused) {
+      new_ids.stack_ids[stack_id] = 0;
+      stack_id = stack_parent_ids_[stack_id];
+    }
+  }
 
-  if (existing_resource_id != resource_map_.end())
-    return existing_resource_id->value;
+  for (wtf_size_t i = 0; i < new_ids.stack_ids.size(); ++i) {
+    if (new_ids.stack_ids[i] != kUnused)
+      new_ids.frame_ids[stack_frame_ids_[i]] = 0;
+  }
+  for (wtf_size_t i = 0; i < new_ids.frame_ids.size(); ++i) {
+    if (new_ids.frame_ids[i] == kUnused)
+      continue;
+    new_ids.function_name_ids[frame_function_name_ids_[i]] = 0;
+    if (frame_resource_ids_[i] != kNoId)
+      new_ids.resource_ids[frame_resource_ids_[i]] = 0;
+  }
 
-  wtf_size_t resource_id = resources_.size();
-  resources_.push_back(resource_name);
-  resource_map_.Set(resource_name, resource_id);
+  AssignNewIds(new_ids.stack_ids);
+  AssignNewIds(new_ids.frame_ids);
+  AssignNewIds(new_ids.function_name_ids);
+  AssignNewIds(new_ids.resource_ids);
+  return new_ids;
+}
 
-  return resource_id;
+void ProfilerTraceBuilder::Compact() {
+  TRACE_EVENT0("blink", "ProfilerTraceBuilder::Compact");
+  const NewIds new_ids = ComputeNewIds();
+
+  CompactStrings(new_ids.function_name_ids, function_names_,
+                 function_name_ids_);
+  CompactStrings(new_ids.resource_ids, resources_, resource_ids_);
+
+  frame_ids_.clear();
+  wtf_size_t frame_count = 0;
+  for (wtf_size_t i = 0; i < frame_function_name_ids_.size(); ++i) {
+    if (new_ids.frame_ids[i] == kUnused)
+      continue;
+    const wtf_size_t function_name_id =
+        new_ids.function_name_ids[frame_function_name_ids_[i]];
+    const wtf_size_t resource_id =
+        frame_resource_ids_[i] == kNoId
+            ? kNoId
+            : new_ids.resource_ids[frame_resource_ids_[i]];
+    frame_function_name_ids_[frame_count] = function_name_id;
+    frame_resource_ids_[frame_count] = resource_id;
+    frame_lines_[frame_count] = frame_lines_[i];
+    frame_columns_[frame_count] = frame_columns_[i];
+    frame_ids_.insert(
+        FrameKey(function_name_id, resource_id, frame_lines_[i],
+                 frame_columns_[i]),
+        frame_count);
+    ++frame_count;
+  }
+  frame_function_name_ids_.Shrink(frame_count);
+  frame_resource_ids_.Shrink(frame_count);
+  frame_lines_.Shrink(frame_count);
+  frame_columns_.Shrink(frame_count);
+
+  // A parent precedes its children, so it has been renumbered already.
+  stack_ids_.clear();
+  wtf_size_t stack_count = 0;
+  for (wtf_size_t i = 0; i < stack_parent_ids_.size(); ++i) {
+    if (new_ids.stack_ids[i] == kUnused)
+      continue;
+    const wtf_size_t parent_stack_id =
+        stack_parent_ids_[i] == kNoId ? kNoId
+                                      : new_ids.stack_ids[stack_parent_ids_[i]];
+    const wtf_size_t frame_id = new_ids.frame_ids[stack_frame_ids_[i]];
+    stack_parent_ids_[stack_count] = parent_stack_id;
+    stack_frame_ids_[stack_count] = frame_id;
+    stack_ids_.insert(StackKey(parent_stack_id, frame_id), stack_count);
+    ++stack_count;
+  }
+  stack_parent_ids_.Shrink(stack_count);
+  stack_frame_ids_.Shrink(stack_count);
+
+  for (wtf_size_t& stack_id : sample_stack_ids_) {
+    if (stack_id != kNoId)
+      stack_id = new_ids.stack_ids[stack_id];
+  }
+  // The nodes of the dropped stacks are looked up again if they are sampled
+  // again.
+  Vector<const v8::CpuProfileNode*> dropped_nodes;
+  for (auto& entry : node_to_stack_map_) {
+    if (entry.value == kNoId)
+      continue;
+    entry.value = new_ids.stack_ids[entry.value];
+    if (entry.value == kUnused)
+      dropped_nodes.push_back(entry.key);
+  }
+  for (const v8::CpuProfileNode* node : dropped_nodes)
+    node_to_stack_map_.erase(node);
 }
 
 ProfilerTrace* ProfilerTraceBuilder::GetTrace() const {
+  TRACE_EVENT0("blink", "ProfilerTraceBuilder::GetTrace");
+
+  // Once the ring buffer has dropped samples, some stacks, frames and
+  // resources may not be referred to any more.  Only the ones in use are
+  // included in the trace, with new IDs in the same order.
+  const NewIds new_ids = ComputeNewIds();
+  const Vector<wtf_size_t>& new_stack_ids = new_ids.stack_ids;
+  const Vector<wtf_size_t>& new_frame_ids = new_ids.frame_ids;
+  const Vector<wtf_size_t>& new_resource_ids = new_ids.resource_ids;
+
+  Vector<String> resources;
+  for (wtf_size_t i = 0; i < resources_.size(); ++i) {
+    if (new_resource_ids[i] != kUnused)
+      resources.push_back(resources_[i]);
+  }
+
+  HeapVector<Member<ProfilerFrame>> frames;
+  for (wtf_size_t i = 0; i < frame_function_name_ids_.size(); ++i) {
+    if (new_frame_ids[i] == kUnused)
+      continue;
+    auto* frame = ProfilerFrame::Create();
+    frame->setName(function_names_[frame_function_name_ids_[i]]);
+    if (frame_resource_ids_[i] != kNoId)
+      frame->setResourceId(new_resource_ids[frame_resource_ids_[i]]);
+    if (frame_lines_[i] != v8::CpuProfileNode::kNoLineNumberInfo)
+      frame->setLine(frame_lines_[i]);
+    if (frame_columns_[i] != v8::CpuProfileNode::kNoColumnNumberInfo)
+      frame->setColumn(frame_columns_[i]);
+    frames.push_back(frame);
+  }
+
+  HeapVector<Member<ProfilerStack>> stacks;
+  for (wtf_size_t i = 0; i < stack_parent_ids_.size(); ++i) {
+    if (new_stack_ids[i] == kUnused)
+      continue;
+    auto* stack = ProfilerStack::Create();
+    stack->setFrameId(new_frame_ids[stack_frame_ids_[i]]);
+    if (stack_parent_ids_[i] != kNoId)
+      stack->setParentId(new_stack_ids[stack_parent_ids_[i]]);
+    stacks.push_back(stack);
+  }
+
+  HeapVector<Member<ProfilerSample>> samples;
+  const wtf_size_t sample_count = sample_timestamps_.size();
+  samples.ReserveInitialCapacity(sample_count);
+  for (wtf_size_t i = 0; i < sample_count; ++i) {
+    const wtf_size_t index = (first_sample_index_ + i) % sample_count;
+    auto* sample = ProfilerSample::Create();
+    sample->setTimestamp(sample_timestamps_[index]);
+    if (sample_stack_ids_[index] != kNoId)
+      sample->setStackId(new_stack_ids[sample_stack_ids_[index]]);
+    if (sample_markers_[index]) {
+      sample->setMarker(V8ProfilerMarker(
+          static_cast<V8ProfilerMarker::Enum>(sample_markers_[index] - 1)));
+    }
+    samples.push_back(sample);
+  }
+
   ProfilerTrace* trace = ProfilerTrace::Create();
-  trace->setResources(resources_);
-  trace->setFrames(frames_);
-  trace->setStacks(stacks_);
-  trace->setSamples(samples_);
+  trace->setResources(resources);
+  trace->setFrames(frames);
+  trace->setStacks(stacks);
+  trace->setSamples(samples);
   return trace;
 }
 
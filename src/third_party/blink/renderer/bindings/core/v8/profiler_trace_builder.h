@@ -5,26 +5,26 @@
 #ifndef THIRD_PARTY_BLINK_RENDERER_BINDINGS_CORE_V8_PROFILER_TRACE_BUILDER_H_
 #define THIRD_PARTY_BLINK_RENDERER_BINDINGS_CORE_V8_PROFILER_TRACE_BUILDER_H_
 
+#include <limits>
+#include <utility>
+
 #include "base/gtest_prod_util.h"
 #include "base/time/time.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_core.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_profiler_marker.h"
-#include "third_party/blink/renderer/platform/heap/collection_support/heap_vector.h"
 #include "third_party/blink/renderer/platform/heap/garbage_collected.h"
 #include "third_party/blink/renderer/platform/heap/member.h"
 #include "third_party/blink/renderer/platform/weborigin/security_origin.h"
 #include "third_party/blink/renderer/platform/wtf/forward.h"
 #include "third_party/blink/renderer/platform/wtf/hash_map.h"
 #include "third_party/blink/renderer/platform/wtf/text/string_hash.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
 #include "third_party/blink/renderer/platform/wtf/wtf_size_t.h"
 #include "v8/include/v8-profiler.h"
 
 namespace blink {
 
-class ProfilerFrame;
-class ProfilerSample;
-class ProfilerStack;
 class ProfilerTrace;
 class ScriptState;
 
@@ -43,31 +43,22 @@ struct ProfilerNodeStackHash {
   static const bool safe_to_compare_to_empty_or_deleted = false;
 };
 
-// A hash uniquely identified by the stack frame associated with the node.
-struct ProfilerNodeFrameHash {
-  STATIC_ONLY(ProfilerNodeFrameHash);
-
-  static bool Equal(const v8::CpuProfileNode* a, const v8::CpuProfileNode* b) {
-    return a->GetFunctionName() == b->GetFunctionName() &&
-           a->GetScriptResourceName() == b->GetScriptResourceName() &&
-           a->GetLineNumber() == b->GetLineNumber() &&
-           a->GetColumnNumber() == b->GetColumnNumber();
-  }
-
-  static unsigned GetHash(const v8::CpuProfileNode* node) {
-    return StringHash::GetHash(node->GetFunctionNameStr()) ^
-           StringHash::GetHash(node->GetScriptResourceNameStr()) ^
-           DefaultHash<unsigned>::Hash().GetHash(node->GetLineNumber()) ^
-           DefaultHash<unsigned>::Hash().GetHash(node->GetColumnNumber());
-  }
-
-  static const bool safe_to_compare_to_empty_or_deleted = false;
-};
-
-// Produces a structurally compressed trace from a v8::CpuProfile relative to a
+// Produces a structurally compressed trace from v8::CpuProfiles relative to a
 // time origin, and omits frames from cross-origin scripts that do not
 // participate in CORS.
 //
+// Samples can be added incrementally from consecutive profiles, e.g. when the
+// profiling is restarted periodically, so that most of the work is done while
+// the profiling is running.  The frames and the stacks are interned by their
+// contents across profiles, and kept in compact tables of plain values.  The
+// GC objects of the trace are created only when the trace is handed to script
+// by GetTrace().  If |max_samples| is not zero, only the newest |max_samples|
+// samples are kept, and the trace includes only the stacks, frames and
+// resources that they refer to.  The tables are compacted to what the kept
+// samples refer to whenever the ring buffer rolls over, so they stay bounded
+// by twice the |max_samples| samples' worth; only the cache of the same-origin
+// checks keeps growing, by an entry per script.
+//
 // The trace format is described at:
 // https://wicg.github.io/js-self-profiling/#the-profilertrace-dictionary
 class CORE_EXPORT ProfilerTraceBuilder final
@@ -80,28 +71,57 @@ class CORE_EXPORT ProfilerTraceBuilder final
 
   explicit ProfilerTraceBuilder(ScriptState*,
                                 const SecurityOrigin* allowed_origin,
-                                base::TimeTicks time_origin);
+                                base::TimeTicks time_origin,
+                                wtf_size_t max_samples = 0);
 
   ProfilerTraceBuilder(const ProfilerTraceBuilder&) = delete;
   ProfilerTraceBuilder& operator=(const ProfilerTraceBuilder&) = delete;
 
   void Trace(Visitor*) const;
 
+  // Adds all the samples of |profile| to the trace.  |profile| may be deleted
+  // after this call.
+  void AddProfile(const v8::CpuProfile* profile);
+
+  // Creates the trace of the samples added so far.
+  ProfilerTrace* GetTrace() const;
+
+  wtf_size_t SampleCount() const { return sample_timestamps_.size(); }
+
  private:
+  static constexpr wtf_size_t kNoId = std::numeric_limits<wtf_size_t>::max();
+
   // Adds a stack sample from V8 to the trace, performing necessary filtering
   // and coalescing.
   void AddSample(const v8::CpuProfileNode* node,
                  base::TimeTicks timestamp,
                  const v8::StateTag);
   // Obtains the stack ID of the substack with the given node as its leaf,
-  // performing origin-based filtering.
-  absl::optional<wtf_size_t> GetOrInsertStackId(const v8::CpuProfileNode* node);
+  // performing origin-based filtering.  Returns kNoId for an empty stack.
+  wtf_size_t GetOrInsertStackId(const v8::CpuProfileNode* node);
   // Obtains the frame ID of the stack frame represented by the given node.
   wtf_size_t GetOrInsertFrameId(const v8::CpuProfileNode* node);
-  // Obtains the resource ID for the given resource name.
-  wtf_size_t GetOrInsertResourceId(const char* resource_name);
-
-  ProfilerTrace* GetTrace() const;
+  // Obtains the index of |string| in |strings|, adding it if needed.
+  static wtf_size_t GetOrInsertStringId(
+      const char* string,
+      Vector<String>& strings,
+      HashMap<String, wtf_size_t>& string_ids);
+
+  // The new IDs of the entries of the tables, for dropping the entries which
+  // are not referred to.  See ComputeNewIds().
+  struct NewIds {
+    Vector<wtf_size_t> stack_ids;
+    Vector<wtf_size_t> frame_ids;
+    Vector<wtf_size_t> function_name_ids;
+    Vector<wtf_size_t> resource_ids;
+  };
+  // Computes consecutive new IDs, in the same order, for the stacks that the
+  // samples refer to, and for the frames, function names and resources that
+  // those stacks refer to.  The other entries get an ID out of range.
+  NewIds ComputeNewIds() const;
+  // Drops the entries of the tables that no sample refers to any more, and
+  // renumbers the others.
+  void Compact();
 
   inline absl::optional<V8ProfilerMarker> VMStateToMarker(v8::StateTag state) {
     switch (state) {
@@ -124,24 +144,50 @@ class CORE_EXPORT ProfilerTraceBuilder final
 
   const SecurityOrigin* allowed_origin_;
   const base::TimeTicks time_origin_;
+  const wtf_size_t max_samples_;
 
   Vector<String> resources_;
-  HeapVector<Member<ProfilerFrame>> frames_;
-  HeapVector<Member<ProfilerStack>> stacks_;
-  HeapVector<Member<ProfilerSample>> samples_;
-
-  // Maps V8-managed resource strings to their indices in the resources table.
-  HashMap<const char*, wtf_size_t> resource_map_;
+  HashMap<String, wtf_size_t> resource_ids_;
+  Vector<String> function_names_;
+  HashMap<String, wtf_size_t> function_name_ids_;
+
+  // The frames as a struct of arrays indexed by frame ID, interned by the
+  // function name, the resource, the line and the column.  A frame without a
+  // resource has kNoId as the resource ID.
+  Vector<wtf_size_t> frame_function_name_ids_;
+  Vector<wtf_size_t> frame_resource_ids_;
+  Vector<int> frame_lines_;
+  Vector<int> frame_columns_;
+  HashMap<std::pair<uint64_t, uint64_t>, wtf_size_t> frame_ids_;
+
+  // The stack trie as a struct of arrays indexed by stack ID, interned by the
+  // parent stack and the frame.  A parent always has a smaller ID than its
+  // children, and a root stack has kNoId as the parent ID.
+  Vector<wtf_size_t> stack_parent_ids_;
+  Vector<wtf_size_t> stack_frame_ids_;
+  HashMap<uint64_t, wtf_size_t> stack_ids_;
+
+  // The samples as a struct of arrays.  If |max_samples_| is not zero, they
+  // are a ring buffer whose oldest sample is at |first_sample_index_|.  A
+  // sample with an empty stack has kNoId as the stack ID, and the markers are
+  // V8ProfilerMarker::Enum values plus one, or zero for no marker.
+  Vector<double> sample_timestamps_;
+  Vector<wtf_size_t> sample_stack_ids_;
+  Vector<uint8_t> sample_markers_;
+  wtf_size_t first_sample_index_ = 0;
+
+  // The stack IDs of the nodes of the profile being added.  Cleared after
+  // each profile, since the nodes are owned by the profile.
   HashMap<const v8::CpuProfileNode*, wtf_size_t, ProfilerNodeStackHash>
       node_to_stack_map_;
-  HashMap<const v8::CpuProfileNode*, wtf_size_t, ProfilerNodeFrameHash>
-      node_to_frame_map_;
 
   // A mapping from a V8 internal script ID to whether or not it passes the
   // same-origin policy for the ScriptState that the trace belongs to.
   HashMap<int, bool> script_same_origin_cache_;
 
   FRIEND_TEST_ALL_PREFIXES(ProfilerTraceBuilderTest, AddVMStateMarker);
+  FRIEND_TEST_ALL_PREFIXES(ProfilerTraceBuilderTest, RingBuffer);
+  FRIEND_TEST_ALL_PREFIXES(ProfilerTraceBuilderTest, RingBufferCompaction);
 };
 
 }  // namespace blink
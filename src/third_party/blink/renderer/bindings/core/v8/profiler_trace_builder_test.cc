@@ -7,12 +7,87 @@
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_testing.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_profiler_frame.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_profiler_marker.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_profiler_sample.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_profiler_stack.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_profiler_trace.h"
+#include "third_party/blink/renderer/platform/weborigin/kurl.h"
+#include "third_party/blink/renderer/platform/weborigin/security_origin.h"
+#include "third_party/blink/renderer/platform/wtf/text/string_builder.h"
+#include "v8/include/v8-profiler.h"
 #include "v8/include/v8.h"
+
 namespace blink {
 
+namespace {
+
+constexpr char kScriptUrl[] = "https://example.com/profile.js";
+constexpr int kFunctionCount = 1000;
+constexpr int kDepth = 20;
+
+void CollectSample(const v8::FunctionCallbackInfo<v8::Value>& info) {
+  v8::CpuProfiler::CollectSample(info.GetIsolate());
+}
+
+// Profiles a script that defines |kFunctionCount| functions, each of which
+// recurses |kDepth| times and then collects a sample, and calls all of them.
+// The caller must delete the returned profile.
+v8::CpuProfile* ProfileSyntheticScript(V8TestingScope& scope,
+                                       v8::CpuProfiler* profiler) {
+  v8::Isolate* isolate = scope.GetIsolate();
+  v8::Local<v8::Context> context = scope.GetContext();
+  context->Global()
+      ->Set(context, V8String(isolate, "collectSample"),
+            v8::Function::New(context, CollectSample).ToLocalChecked())
+      .Check();
+
+  StringBuilder code;
+  for (int i = 0; i < kFunctionCount; ++i) {
+    code.Append(String::Format(
+        "function f%d(n) { if (n) f%d(n - 1); else collectSample(); }\n", i,
+        i));
+  }
+  for (int i = 0; i < kFunctionCount; ++i)
+    code.Append(String::Format("f%d(%d);\n", i, kDepth));
+
+  v8::Local<v8::String> title = V8String(isolate, "synthetic");
+  // Sample only on CollectSample, as far as possible.
+  profiler->StartProfiling(
+      title, v8::CpuProfilingOptions(v8::kLeafNodeLineNumbers,
+                                     v8::CpuProfilingOptions::kNoSampleLimit,
+                                     /*sampling_interval_us=*/10000000));
+  v8::ScriptOrigin origin(isolate, V8String(isolate, kScriptUrl));
+  v8::ScriptCompiler::Source source(V8String(isolate, code.ToString()),
+                                    origin);
+  v8::ScriptCompiler::Compile(context, &source)
+      .ToLocalChecked()
+      ->Run(context)
+      .ToLocalChecked();
+  return profiler->StopProfiling(title);
+}
+
+// Checks that all of the IDs in |trace| refer to existing entries, and that
+// parent stacks precede their children.
+void ExpectValidTrace(ProfilerTrace* trace) {
+  for (const auto& frame : trace->frames()) {
+    if (frame->hasResourceId())
+      EXPECT_LT(frame->resourceId(), trace->resources().size());
+  }
+  const auto& stacks = trace->stacks();
+  for (wtf_size_t i = 0; i < stacks.size(); ++i) {
+    EXPECT_LT(stacks[i]->frameId(), trace->frames().size());
+    if (stacks[i]->hasParentId())
+      EXPECT_LT(stacks[i]->parentId(), i);
+  }
+  for (const auto& sample : trace->samples()) {
+    if (sample->hasStackId())
+      EXPECT_LT(sample->stackId(), stacks.size());
+  }
+}
+
+}  // namespace
+
 TEST(ProfilerTraceBuilderTest, AddVMStateMarker) {
   V8TestingScope scope;
   auto* script_state = scope.GetScriptState();
@@ -30,4 +105,154 @@ TEST(ProfilerTraceBuilderTest, AddVMStateMarker) {
   EXPECT_EQ(sample->marker(), V8ProfilerMarker::Enum::kGc);
 }
 
+TEST(ProfilerTraceBuilderTest, RingBuffer) {
+  V8TestingScope scope;
+  auto* script_state = scope.GetScriptState();
+
+  base::TimeTicks time_origin = base::TimeTicks::Now();
+  ProfilerTraceBuilder* builder = MakeGarbageCollected<ProfilerTraceBuilder>(
+      script_state, nullptr, time_origin, /*max_samples=*/3);
+
+  for (int i = 1; i <= 5; ++i) {
+    builder->AddSample(nullptr, time_origin + base::Milliseconds(i),
+                       i % 2 ? v8::StateTag::GC : v8::StateTag::JS);
+  }
+  EXPECT_EQ(builder->SampleCount(), 3u);
+
+  const auto& samples = builder->GetTrace()->samples();
+  ASSERT_EQ(samples.size(), 3u);
+  // The oldest two samples are dropped, and the others stay in order.
+  EXPECT_EQ(samples[0]->marker(), V8ProfilerMarker::Enum::kGc);
+  EXPECT_EQ(samples[1]->marker(), V8ProfilerMarker::Enum::kScript);
+  EXPECT_EQ(samples[2]->marker(), V8ProfilerMarker::Enum::kGc);
+  EXPECT_GT(samples[0]->timestamp(), 1.5);
+  EXPECT_LT(samples[0]->timestamp(), samples[1]->timestamp());
+  EXPECT_LT(samples[1]->timestamp(), samples[2]->timestamp());
+}
+
+TEST(ProfilerTraceBuilderTest, LargeProfile) {
+  V8TestingScope scope;
+  v8::Isolate* isolate = scope.GetIsolate();
+  v8::CpuProfiler* profiler = v8::CpuProfiler::New(isolate);
+  v8::CpuProfile* profile = ProfileSyntheticScript(scope, profiler);
+  ASSERT_TRUE(profile);
+
+  scoped_refptr<const SecurityOrigin> allowed_origin =
+      SecurityOrigin::Create(KURL("https://example.com"));
+  ProfilerTraceBuilder* builder = MakeGarbageCollected<ProfilerTraceBuilder>(
+      scope.GetScriptState(), allowed_origin.get(), base::TimeTicks::Now());
+  builder->AddProfile(profile);
+  ProfilerTrace* trace = builder->GetTrace();
+  ExpectValidTrace(trace);
+
+  EXPECT_GE(trace->samples().size(), static_cast<wtf_size_t>(kFunctionCount));
+  EXPECT_TRUE(trace->resources().Contains(kScriptUrl));
+  // All of the recursive calls of a function share a frame, but not a stack.
+  EXPECT_GE(trace->frames().size(), static_cast<wtf_size_t>(kFunctionCount));
+  EXPECT_GE(trace->stacks().size(),
+            static_cast<wtf_size_t>(kFunctionCount * (kDepth + 1)));
+  EXPECT_LT(trace->frames().size(), trace->stacks().size());
+
+  // The frames and the stacks of the same profile are interned.
+  builder->AddProfile(profile);
+  ProfilerTrace* doubled_trace = builder->GetTrace();
+  ExpectValidTrace(doubled_trace);
+  EXPECT_EQ(doubled_trace->samples().size(), 2 * trace->samples().size());
+  EXPECT_EQ(doubled_trace->frames().size(), trace->frames().size());
+  EXPECT_EQ(doubled_trace->stacks().size(), trace->stacks().size());
+  EXPECT_EQ(doubled_trace->resources().size(), trace->resources().size());
+
+  profile->Delete();
+  profiler->Dispose();
+}
+
+TEST(ProfilerTraceBuilderTest, LargeProfileInRingBuffer) {
+  V8TestingScope scope;
+  v8::Isolate* isolate = scope.GetIsolate();
+  v8::CpuProfiler* profiler = v8::CpuProfiler::New(isolate);
+  v8::CpuProfile* profile = ProfileSyntheticScript(scope, profiler);
+  ASSERT_TRUE(profile);
+
+  scoped_refptr<const SecurityOrigin> allowed_origin =
+      SecurityOrigin::Create(KURL("https://example.com"));
+  ProfilerTraceBuilder* builder = MakeGarbageCollected<ProfilerTraceBuilder>(
+      scope.GetScriptState(), allowed_origin.get(), base::TimeTicks::Now(),
+      /*max_samples=*/1);
+  builder->AddProfile(profile);
+  ProfilerTrace* trace = builder->GetTrace();
+  ExpectValidTrace(trace);
+
+  // Only the stacks, frames and resources of the last sample are left.
+  const auto& samples = trace->samples();
+  ASSERT_EQ(samples.size(), 1u);
+  wtf_size_t stack_depth = 0;
+  if (samples[0]->hasStackId()) {
+    const auto& stacks = trace->stacks();
+    for (const ProfilerStack* stack = stacks[samples[0]->stackId()];;
+         stack = stacks[stack->parentId()]) {
+      ++stack_depth;
+      if (!stack->hasParentId())
+        break;
+    }
+  }
+  EXPECT_EQ(trace->stacks().size(), stack_depth);
+  EXPECT_LE(trace->frames().size(), stack_depth);
+  EXPECT_LE(trace->resources().size(), 1u);
+
+  profile->Delete();
+  profiler->Dispose();
+}
+
+TEST(ProfilerTraceBuilderTest, RingBufferCompaction) {
+  V8TestingScope scope;
+  v8::Isolate* isolate = scope.GetIsolate();
+  v8::CpuProfiler* profiler = v8::CpuProfiler::New(isolate);
+  v8::CpuProfile* profile = ProfileSyntheticScript(scope, profiler);
+  ASSERT_TRUE(profile);
+
+  constexpr wtf_size_t kMaxSamples = 10;
+  scoped_refptr<const SecurityOrigin> allowed_origin =
+      SecurityOrigin::Create(KURL("https://example.com"));
+  ProfilerTraceBuilder* builder = MakeGarbageCollected<ProfilerTraceBuilder>(
+      scope.GetScriptState(), allowed_origin.get(), base::TimeTicks::Now(),
+      kMaxSamples);
+
+  // The tables hold at most what the samples since the last but one roll-over
+  // refer to, rather than what all of the |kFunctionCount| functions do.
+  auto expect_compacted = [&]() {
+    const wtf_size_t max_stack_count = 2 * kMaxSamples * (kDepth + 5);
+    ASSERT_LT(max_stack_count, static_cast<wtf_size_t>(kFunctionCount));
+    EXPECT_LE(builder->stack_parent_ids_.size(), max_stack_count);
+    EXPECT_EQ(builder->stack_ids_.size(), builder->stack_parent_ids_.size());
+    EXPECT_LE(builder->frame_function_name_ids_.size(),
+              builder->stack_parent_ids_.size());
+    EXPECT_EQ(builder->frame_ids_.size(),
+              builder->frame_function_name_ids_.size());
+    EXPECT_LE(builder->function_names_.size(),
+              builder->frame_function_name_ids_.size());
+    EXPECT_EQ(builder->function_name_ids_.size(),
+              builder->function_names_.size());
+    EXPECT_LE(builder->resources_.size(), 1u);
+    EXPECT_EQ(builder->resource_ids_.size(), builder->resources_.size());
+  };
+
+  builder->AddProfile(profile);
+  expect_compacted();
+  ProfilerTrace* trace = builder->GetTrace();
+  ExpectValidTrace(trace);
+  EXPECT_EQ(trace->samples().size(), kMaxSamples);
+
+  // The entries left by the compaction are still interned, so the same last
+  // samples refer to as many stacks and frames.
+  builder->AddProfile(profile);
+  expect_compacted();
+  ProfilerTrace* next_trace = builder->GetTrace();
+  ExpectValidTrace(next_trace);
+  EXPECT_EQ(next_trace->stacks().size(), trace->stacks().size());
+  EXPECT_EQ(next_trace->frames().size(), trace->frames().size());
+
+  profile->Delete();
+  profiler->Dispose();
+}
+
 }  // namespace blink
@@ -0,0 +1,34 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/test/perf_test_suite.h"
+#include "content/public/test/blink_test_environment.h"
+
+namespace {
+
+// Sets up Blink in the same way as blink_unittests, so that the benchmarks
+// can use V8TestingScope.
+class BindingsPerfTestSuite : public base::PerfTestSuite {
+ public:
+  BindingsPerfTestSuite(int argc, char** argv)
+      : base::PerfTestSuite(argc, argv) {}
+
+  void Initialize() override {
+    base::PerfTestSuite::Initialize();
+    content::SetUpBlinkTestEnvironment();
+  }
+
+  void Shutdown() override {
+    content::TearDownBlinkTestEnvironment();
+    base::PerfTestSuite::Shutdown();
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // The benchmarks run one after another in this process, unlike unit tests
+  // under the test launcher, so that they don't compete for the CPU.
+  return BindingsPerfTestSuite(argc, argv).Run();
+}
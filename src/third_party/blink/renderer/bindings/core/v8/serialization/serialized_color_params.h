@@ -27,8 +27,12 @@ enum class ImageSerializationTag : uint32_t {
   kIsPremultipliedTag = 5,
   // followed by 1 if the image is known to be opaque (alpha = 1 everywhere)
   kCanvasOpacityModeTag = 6,
+  // followed by the index of the out-of-line chunk which holds the pixels,
+  // used only for ImageData which is not for storage.  The pixels are not
+  // written inline then.
+  kOutOfLineChunkTag = 7,
 
-  kLast = kCanvasOpacityModeTag,
+  kLast = kOutOfLineChunkTag,
 };
 
 // This enumeration specifies the values used to serialize PredefinedColorSpace.
@@ -275,7 +275,7 @@ SerializedScriptValue::~SerializedScriptValue() {
   if (has_registered_external_allocation_) {
     DCHECK(v8::Isolate::GetCurrent());
     v8::Isolate::GetCurrent()->AdjustAmountOfExternalAllocatedMemory(
-        -static_cast<int64_t>(DataLengthInBytes()));
+        -static_cast<int64_t>(ExternalAllocationSize()));
   }
 }
 
@@ -295,6 +295,7 @@ scoped_refptr<SerializedScriptValue> SerializedScriptValue::UndefinedValue() {
 }
 
 String SerializedScriptValue::ToWireString() const {
+  CHECK(out_of_line_chunks_.IsEmpty());
   // Add the padding '\0', but don't put it in |data_buffer_|.
   // This requires direct use of uninitialized strings, though.
   UChar* destination;
@@ -640,7 +641,7 @@ void SerializedScriptValue::
     UnregisterMemoryAllocatedWithCurrentScriptContext() {
   if (has_registered_external_allocation_) {
     v8::Isolate::GetCurrent()->AdjustAmountOfExternalAllocatedMemory(
-        -static_cast<int64_t>(DataLengthInBytes()));
+        -static_cast<int64_t>(ExternalAllocationSize()));
     has_registered_external_allocation_ = false;
   }
 }
@@ -650,11 +651,18 @@ void SerializedScriptValue::RegisterMemoryAllocatedWithCurrentScriptContext() {
     return;
 
   has_registered_external_allocation_ = true;
-  int64_t diff = static_cast<int64_t>(DataLengthInBytes());
+  int64_t diff = static_cast<int64_t>(ExternalAllocationSize());
   DCHECK_GE(diff, 0);
   v8::Isolate::GetCurrent()->AdjustAmountOfExternalAllocatedMemory(diff);
 }
 
+size_t SerializedScriptValue::ExternalAllocationSize() const {
+  size_t size = DataLengthInBytes();
+  for (const auto& chunk : out_of_line_chunks_)
+    size += chunk.DataLength();
+  return size;
+}
+
 // This ensures that the version number published in
 // WebSerializedScriptValueVersion.h matches the serializer's understanding.
 // TODO(jbroman): Fix this to also account for the V8-side version. See
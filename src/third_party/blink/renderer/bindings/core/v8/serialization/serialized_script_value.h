@@ -104,6 +104,7 @@ class CORE_EXPORT SerializedScriptValue
   using StreamArray = Vector<Stream>;
   using FileSystemAccessTokensArray =
       Vector<mojo::PendingRemote<mojom::blink::FileSystemAccessTransferToken>>;
+  using OutOfLineChunkArray = Vector<ArrayBufferContents>;
 
   // Increment this for each incompatible change to the wire format.
   // Version 2: Added StringUCharTag for UChar v8 strings.
@@ -167,6 +168,18 @@ class CORE_EXPORT SerializedScriptValue
     WebBlobInfoArray* blob_info = nullptr;
     WasmSerializationPolicy wasm_policy = kTransfer;
     StoragePolicy for_storage = kNotForStorage;
+    // Allows the pixels of a large ImageData to be kept in an out-of-line
+    // chunk rather than copied into the wire data, which then refers to the
+    // chunk by index.  The pixels are still copied once, into a chunk of the
+    // exact size.  ArrayBuffers and typed arrays stay in the wire data, since
+    // V8 writes them itself.  Only for values which are not for storage and
+    // which never leave the process as wire data: the chunks are not part of
+    // the wire data, so GetWireData() and ToWireString() CHECK that there are
+    // none.
+    //
+    // No message path sets this yet.  It is meant for the in-process delivery
+    // of worker messages, whose values are never turned into wire data.
+    bool use_out_of_line_chunks = false;
   };
   static scoped_refptr<SerializedScriptValue> Serialize(v8::Isolate*,
                                                         v8::Local<v8::Value>,
@@ -188,9 +201,11 @@ class CORE_EXPORT SerializedScriptValue
   static scoped_refptr<SerializedScriptValue> NullValue();
   static scoped_refptr<SerializedScriptValue> UndefinedValue();
 
+  // These CHECK that the value has no out-of-line chunks, which are not part
+  // of the wire data and would be lost.
   String ToWireString() const;
-
   base::span<const uint8_t> GetWireData() const {
+    CHECK(out_of_line_chunks_.IsEmpty());
     return {data_buffer_.get(), data_buffer_size_};
   }
 
@@ -287,6 +302,20 @@ class CORE_EXPORT SerializedScriptValue
 
   StreamArray& GetStreams() { return streams_; }
 
+  // The chunks of the data which are kept out of line of the wire data.  See
+  // SerializeOptions::use_out_of_line_chunks.  Unlike the transferred
+  // contents, they are kept after unpacking, as the value may be deserialized
+  // multiple times.
+  const OutOfLineChunkArray& OutOfLineChunks() const {
+    return out_of_line_chunks_;
+  }
+  // The chunks count towards the external memory reported to V8, so they must
+  // be set before the value is registered with a script context.
+  void SetOutOfLineChunks(OutOfLineChunkArray chunks) {
+    DCHECK(!has_registered_external_allocation_);
+    out_of_line_chunks_ = std::move(chunks);
+  }
+
   bool IsLockedToAgentCluster() const {
     return !wasm_modules_.IsEmpty() ||
            !shared_array_buffers_contents_.IsEmpty() ||
@@ -374,8 +403,13 @@ class CORE_EXPORT SerializedScriptValue
 
   void CloneSharedArrayBuffers(SharedArrayBufferArray&);
 
+  // The size of the data buffer and the out-of-line chunks, which is reported
+  // to V8 as external memory.
+  size_t ExternalAllocationSize() const;
+
   DataBufferPtr data_buffer_;
   size_t data_buffer_size_ = 0;
+  OutOfLineChunkArray out_of_line_chunks_;
 
   // These two have one-use transferred contents, and are stored in
   // UnpackedSerializedScriptValue thereafter.
@@ -37,8 +37,26 @@ WebBlobInfoArray* g_blob_info_array = nullptr;
 enum : uint32_t {
   kFuzzMessagePorts = 1 << 0,
   kFuzzBlobInfo = 1 << 1,
+  kFuzzOutOfLineChunks = 1 << 2,
 };
 
+// Makes out-of-line chunks of the input, so that the references to chunks in
+// the input may resolve to data of various sizes.
+SerializedScriptValue::OutOfLineChunkArray MakeOutOfLineChunks(
+    const uint8_t* data,
+    size_t size) {
+  SerializedScriptValue::OutOfLineChunkArray chunks;
+  for (size_t chunk_size : {size, size / 2, size % 64}) {
+    ArrayBufferContents chunk(chunk_size, 1, ArrayBufferContents::kNotShared,
+                              ArrayBufferContents::kDontInitialize);
+    if (!chunk.IsValid())
+      continue;
+    std::copy(data, data + chunk_size, static_cast<uint8_t*>(chunk.Data()));
+    chunks.push_back(std::move(chunk));
+  }
+  return chunks;
+}
+
 }  // namespace
 
 int LLVMFuzzerInitialize(int* argc, char*** argv) {
@@ -97,6 +115,8 @@ int LLVMFuzzerTestOneInput(const uint8_t* data, size_t data_size) {
   // Deserialize.
   scoped_refptr<SerializedScriptValue> serialized_script_value =
       SerializedScriptValue::Create(reinterpret_cast<const char*>(data), size);
+  if (hash & kFuzzOutOfLineChunks)
+    serialized_script_value->SetOutOfLineChunks(MakeOutOfLineChunks(data, size));
   serialized_script_value->Deserialize(isolate, options);
   CHECK(!try_catch.HasCaught())
       << "deserialize() should return null rather than throwing an exception.";
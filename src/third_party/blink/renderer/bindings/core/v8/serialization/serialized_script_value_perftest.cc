@@ -0,0 +1,216 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/bindings/core/v8/serialization/serialized_script_value.h"
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+#include "base/timer/lap_timer.h"
+#include "build/build_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/blink/renderer/bindings/core/v8/serialization/unpacked_serialized_script_value.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_testing.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_image_data.h"
+#include "third_party/blink/renderer/core/html/canvas/image_data.h"
+#include "third_party/blink/renderer/platform/bindings/exception_state.h"
+#include "third_party/blink/renderer/platform/bindings/to_v8.h"
+
+namespace blink {
+
+namespace {
+
+constexpr int kWarmupRuns = 2;
+constexpr base::TimeDelta kTimeLimit = base::Seconds(2);
+constexpr int kTimeCheckInterval = 1;
+
+constexpr char kMetricPrefix[] = "SerializedScriptValue.";
+constexpr char kMetricThroughput[] = "throughput";
+constexpr char kMetricWireDataSize[] = "wire_data_size";
+constexpr char kMetricPeakRss[] = "peak_rss";
+constexpr char kMetricRoundTripsPerSecond[] = "round_trips_per_second";
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+// Resets the peak resident set size of the process, so that the next
+// ReadPeakRss() reports the peak of the story alone.
+void ResetPeakRss() {
+  base::WriteFile(base::FilePath("/proc/self/clear_refs"), "5");
+}
+
+absl::optional<uint64_t> ReadPeakRss() {
+  std::string status;
+  if (!base::ReadFileToString(base::FilePath("/proc/self/status"), &status))
+    return absl::nullopt;
+  constexpr base::StringPiece kPeakRssKey = "VmHWM:";
+  size_t begin = status.find(kPeakRssKey.data());
+  if (begin == std::string::npos)
+    return absl::nullopt;
+  begin += kPeakRssKey.size();
+  size_t end = status.find("kB", begin);
+  uint64_t peak_rss_in_kb = 0;
+  if (end == std::string::npos ||
+      !base::StringToUint64(
+          base::TrimWhitespaceASCII(
+              base::StringPiece(status).substr(begin, end - begin),
+              base::TRIM_ALL),
+          &peak_rss_in_kb)) {
+    return absl::nullopt;
+  }
+  return peak_rss_in_kb * 1024;
+}
+#else
+void ResetPeakRss() {}
+
+absl::optional<uint64_t> ReadPeakRss() {
+  return absl::nullopt;
+}
+#endif
+
+// Posts an ImageData of |width| x |height| pixels through a
+// SerializedScriptValue, i.e. serializes it, unpacks it and deserializes it,
+// with the pixels copied into the wire data or kept in an out-of-line chunk.
+void RunImageDataRoundTrip(const std::string& story,
+                           int width,
+                           int height,
+                           bool use_out_of_line_chunks) {
+  V8TestingScope scope;
+  v8::Isolate* isolate = scope.GetIsolate();
+  ImageData* image_data = ImageData::ValidateAndCreate(
+      width, height, absl::nullopt, nullptr,
+      ImageData::ValidateAndCreateParams(), ASSERT_NO_EXCEPTION);
+  v8::Local<v8::Value> wrapper =
+      ToV8(image_data, scope.GetContext()->Global(), isolate);
+  const size_t pixel_byte_length = image_data->GetSkPixmap().computeByteSize();
+
+  perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+  reporter.RegisterImportantMetric(kMetricThroughput, "bytesPerSecond");
+  reporter.RegisterImportantMetric(kMetricWireDataSize, "bytes");
+  reporter.RegisterImportantMetric(kMetricPeakRss, "bytes");
+
+  SerializedScriptValue::SerializeOptions options;
+  options.use_out_of_line_chunks = use_out_of_line_chunks;
+  size_t wire_data_size = 0;
+  ResetPeakRss();
+  base::LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+  do {
+    v8::HandleScope handle_scope(isolate);
+    scoped_refptr<SerializedScriptValue> serialized =
+        SerializedScriptValue::Serialize(isolate, wrapper, options,
+                                         ASSERT_NO_EXCEPTION);
+    ASSERT_TRUE(serialized);
+    wire_data_size = serialized->DataLengthInBytes();
+    v8::Local<v8::Value> result =
+        SerializedScriptValue::Unpack(std::move(serialized))
+            ->Deserialize(isolate);
+    ASSERT_TRUE(V8ImageData::HasInstance(result, isolate));
+    timer.NextLap();
+  } while (!timer.HasTimeLimitExpired());
+
+  reporter.AddResult(kMetricThroughput,
+                     timer.LapsPerSecond() * pixel_byte_length);
+  reporter.AddResult(kMetricWireDataSize, wire_data_size);
+  if (absl::optional<uint64_t> peak_rss = ReadPeakRss())
+    reporter.AddResult(kMetricPeakRss, static_cast<size_t>(*peak_rss));
+}
+
+// Posts the value that |source| evaluates to through a SerializedScriptValue,
+// like RunImageDataRoundTrip.
+void RunRoundTrip(const std::string& story, const char* source) {
+  V8TestingScope scope;
+  v8::Isolate* isolate = scope.GetIsolate();
+  v8::Local<v8::Value> value =
+      v8::Script::Compile(scope.GetContext(), V8String(isolate, source))
+          .ToLocalChecked()
+          ->Run(scope.GetContext())
+          .ToLocalChecked();
+
+  perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+  reporter.RegisterImportantMetric(kMetricRoundTripsPerSecond,
+                                   "roundTrips/s");
+  reporter.RegisterImportantMetric(kMetricWireDataSize, "bytes");
+
+  size_t wire_data_size = 0;
+  base::LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+  do {
+    v8::HandleScope handle_scope(isolate);
+    scoped_refptr<SerializedScriptValue> serialized =
+        SerializedScriptValue::Serialize(
+            isolate, value, SerializedScriptValue::SerializeOptions(),
+            ASSERT_NO_EXCEPTION);
+    ASSERT_TRUE(serialized);
+    wire_data_size = serialized->DataLengthInBytes();
+    v8::Local<v8::Value> result =
+        SerializedScriptValue::Unpack(std::move(serialized))
+            ->Deserialize(isolate);
+    ASSERT_FALSE(result->IsNull());
+    timer.NextLap();
+  } while (!timer.HasTimeLimitExpired());
+
+  reporter.AddResult(kMetricRoundTripsPerSecond, timer.LapsPerSecond());
+  reporter.AddResult(kMetricWireDataSize, wire_data_size);
+}
+
+// Representative payloads of postMessage() and IndexedDB.
+constexpr char kJsonLikeRecords[] = R"(
+    Array.from({length: 100}, (_, i) => ({
+      id: i,
+      name: 'record ' + i,
+      active: i % 2 == 0,
+      score: i / 3,
+      tags: ['alpha', 'beta', 'gamma'].slice(0, i % 4),
+      nested: {created: 1650000000000 + i, owner: {id: i * 7, name: 'owner'}},
+    })))";
+constexpr char kNumberArray[] =
+    "Array.from({length: 10000}, (_, i) => i % 3 ? i : i + 0.5)";
+constexpr char kStringArray[] =
+    "Array.from({length: 1000}, (_, i) => 'string value ' + i)";
+constexpr char kTypedArray[] = "new Float64Array(1 << 17).fill(0.5)";
+constexpr char kMap[] =
+    "new Map(Array.from({length: 1000}, (_, i) => ['key' + i, {value: i}]))";
+
+TEST(SerializedScriptValuePerfTest, JsonLikeRecords) {
+  RunRoundTrip("json_like_records_100", kJsonLikeRecords);
+}
+
+TEST(SerializedScriptValuePerfTest, NumberArray) {
+  RunRoundTrip("number_array_10000", kNumberArray);
+}
+
+TEST(SerializedScriptValuePerfTest, StringArray) {
+  RunRoundTrip("string_array_1000", kStringArray);
+}
+
+TEST(SerializedScriptValuePerfTest, TypedArray1MB) {
+  RunRoundTrip("float64_array_1MB", kTypedArray);
+}
+
+TEST(SerializedScriptValuePerfTest, Map) {
+  RunRoundTrip("map_1000", kMap);
+}
+
+TEST(SerializedScriptValuePerfTest, ImageData16MBInline) {
+  RunImageDataRoundTrip("image_data_16MB_inline", 2048, 2048, false);
+}
+
+TEST(SerializedScriptValuePerfTest, ImageData16MBOutOfLine) {
+  RunImageDataRoundTrip("image_data_16MB_out_of_line", 2048, 2048, true);
+}
+
+TEST(SerializedScriptValuePerfTest, ImageData64MBInline) {
+  RunImageDataRoundTrip("image_data_64MB_inline", 4096, 4096, false);
+}
+
+TEST(SerializedScriptValuePerfTest, ImageData64MBOutOfLine) {
+  RunImageDataRoundTrip("image_data_64MB_out_of_line", 4096, 4096, true);
+}
+
+}  // namespace
+
+}  // namespace blink
@@ -9,8 +9,10 @@
 #include "third_party/blink/renderer/bindings/core/v8/serialization/unpacked_serialized_script_value.h"
 #include "third_party/blink/renderer/bindings/core/v8/to_v8_traits.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_testing.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_image_data.h"
 #include "third_party/blink/renderer/bindings/core/v8/worker_or_worklet_script_controller.h"
 #include "third_party/blink/renderer/core/frame/local_dom_window.h"
+#include "third_party/blink/renderer/core/html/canvas/image_data.h"
 #include "third_party/blink/renderer/core/typed_arrays/dom_array_buffer.h"
 #include "third_party/blink/renderer/core/workers/worker_thread_test_helper.h"
 #include "third_party/blink/renderer/platform/bindings/exception_state.h"
@@ -87,4 +89,83 @@ TEST(SerializedScriptValueThreadedTest,
   worker_thread.WaitForShutdownForTesting();
 }
 
+// The out-of-line chunks of a value are read directly on the receiving thread,
+// and stay alive while the sending thread keeps the value.
+TEST(SerializedScriptValueThreadedTest, DeserializeOutOfLineChunksOnWorker) {
+  V8TestingScope scope;
+
+  // Start a worker.
+  WorkerReportingProxy proxy;
+  WorkerThreadForTest worker_thread(proxy);
+  worker_thread.StartWithSourceCode(scope.GetWindow().GetSecurityOrigin(),
+                                    "/* no worker script */");
+
+  // Create a serialized script value whose ImageData pixels are kept in an
+  // out-of-line chunk.
+  ImageData* image_data = ImageData::ValidateAndCreate(
+      512, 512, absl::nullopt, nullptr, ImageData::ValidateAndCreateParams(),
+      ASSERT_NO_EXCEPTION);
+  SkPixmap pixmap = image_data->GetSkPixmap();
+  for (int y = 0; y < pixmap.height(); ++y) {
+    for (int x = 0; x < pixmap.width(); ++x)
+      *pixmap.writable_addr32(x, y) = static_cast<uint32_t>(y * 512 + x);
+  }
+  SerializedScriptValue::SerializeOptions options;
+  options.use_out_of_line_chunks = true;
+  scoped_refptr<SerializedScriptValue> serialized =
+      SerializedScriptValue::Serialize(
+          scope.GetIsolate(),
+          ToV8(image_data, scope.GetContext()->Global(), scope.GetIsolate()),
+          options, ASSERT_NO_EXCEPTION);
+  ASSERT_TRUE(serialized);
+  ASSERT_EQ(1u, serialized->OutOfLineChunks().size());
+
+  // Deserialize the serialized value on the worker.
+  scoped_refptr<base::SingleThreadTaskRunner> task_runner =
+      worker_thread.GetWorkerBackingThread().BackingThread().GetTaskRunner();
+
+  PostCrossThreadTask(
+      *task_runner, FROM_HERE,
+      CrossThreadBindOnce(
+          [](WorkerThread* worker_thread,
+             scoped_refptr<SerializedScriptValue> serialized) {
+            WorkerOrWorkletScriptController* script =
+                worker_thread->GlobalScope()->ScriptController();
+            EXPECT_TRUE(script->IsContextInitialized());
+            ScriptState::Scope worker_scope(script->GetScriptState());
+            v8::Local<v8::Value> result =
+                SerializedScriptValue::Unpack(serialized)
+                    ->Deserialize(worker_thread->GetIsolate());
+            ASSERT_TRUE(
+                V8ImageData::HasInstance(result, worker_thread->GetIsolate()));
+            SkPixmap pixmap = V8ImageData::ToImpl(result.As<v8::Object>())
+                                  ->GetSkPixmap();
+            EXPECT_EQ(512, pixmap.width());
+            EXPECT_EQ(512, pixmap.height());
+            for (int y = 0; y < pixmap.height(); ++y) {
+              for (int x = 0; x < pixmap.width(); ++x) {
+                ASSERT_EQ(static_cast<uint32_t>(y * 512 + x),
+                          *pixmap.addr32(x, y));
+              }
+            }
+
+            ThreadState::Current()->CollectAllGarbageForTesting();
+          },
+          CrossThreadUnretained(&worker_thread), serialized));
+
+  base::WaitableEvent done;
+  PostCrossThreadTask(*task_runner, FROM_HERE,
+                      CrossThreadBindOnce(&base::WaitableEvent::Signal,
+                                          CrossThreadUnretained(&done)));
+  done.Wait();
+
+  // The chunks are still there, and are freed on the main thread.
+  EXPECT_TRUE(serialized->HasOneRef());
+  EXPECT_EQ(1u, serialized->OutOfLineChunks().size());
+  serialized = nullptr;
+
+  worker_thread.Terminate();
+  worker_thread.WaitForShutdownForTesting();
+}
+
 }  // namespace blink
@@ -238,6 +238,16 @@ bool V8ScriptValueDeserializer::ReadUTF8String(String* string) {
   return !string->IsNull();
 }
 
+bool V8ScriptValueDeserializer::ReadOutOfLineChunk(uint32_t index,
+                                                   size_t size,
+                                                   const void** data) {
+  const auto& chunks = serialized_script_value_->OutOfLineChunks();
+  if (index >= chunks.size() || chunks[index].DataLength() != size)
+    return false;
+  *data = chunks[index].Data();
+  return true;
+}
+
 ScriptWrappable* V8ScriptValueDeserializer::ReadDOMObject(
     SerializationTag tag,
     ExceptionState& exception_state) {
@@ -346,6 +356,7 @@ ScriptWrappable* V8ScriptValueDeserializer::ReadDOMObject(
                 return nullptr;
               break;
             case ImageSerializationTag::kImageDataStorageFormatTag:
+            case ImageSerializationTag::kOutOfLineChunkTag:
               // Does not apply to ImageBitmap.
               return nullptr;
           }
@@ -389,6 +400,7 @@ ScriptWrappable* V8ScriptValueDeserializer::ReadDOMObject(
           SerializedImageDataStorageFormat::kUint8Clamped;
       uint32_t width = 0, height = 0;
       const void* pixels = nullptr;
+      absl::optional<uint32_t> chunk_index;
       if (Version() >= 18) {
         bool is_done = false;
         do {
@@ -408,6 +420,13 @@ ScriptWrappable* V8ScriptValueDeserializer::ReadDOMObject(
                       &image_data_storage_format))
                 return nullptr;
               break;
+            case ImageSerializationTag::kOutOfLineChunkTag: {
+              uint32_t index = 0;
+              if (!ReadUint32(&index))
+                return nullptr;
+              chunk_index = index;
+              break;
+            }
             case ImageSerializationTag::kCanvasPixelFormatTag:
             case ImageSerializationTag::kOriginCleanTag:
             case ImageSerializationTag::kIsPremultipliedTag:
@@ -422,8 +441,13 @@ ScriptWrappable* V8ScriptValueDeserializer::ReadDOMObject(
       size_t byte_length = 0;
       if (!ReadUint32(&width) || !ReadUint32(&height) ||
           !ReadUint64(&byte_length_64) ||
-          !base::MakeCheckedNum(byte_length_64).AssignIfValid(&byte_length) ||
-          !ReadRawBytes(byte_length, &pixels)) {
+          !base::MakeCheckedNum(byte_length_64).AssignIfValid(&byte_length)) {
+        return nullptr;
+      }
+      if (chunk_index) {
+        if (!ReadOutOfLineChunk(*chunk_index, byte_length, &pixels))
+          return nullptr;
+      } else if (!ReadRawBytes(byte_length, &pixels)) {
         return nullptr;
       }
 
@@ -69,6 +69,10 @@ class CORE_EXPORT V8ScriptValueDeserializer
   bool ReadRawBytes(size_t size, const void** data) {
     return deserializer_.ReadRawBytes(size, data);
   }
+  // Reads the data of the out-of-line chunk at |index|, which must be |size|
+  // bytes long, directly from the chunk.  See
+  // V8ScriptValueSerializer::WriteOutOfLineChunk.
+  bool ReadOutOfLineChunk(uint32_t index, size_t size, const void** data);
   bool ReadUTF8String(String* string_out);
   DOMRectReadOnly* ReadDOMRectReadOnly();
 
@@ -77,6 +77,14 @@ namespace blink {
 // made to how Blink writes data. Purely V8-side changes do not require an
 // adjustment to this value.
 
+namespace {
+
+// Smaller data is copied into the wire data, as growing the wire data costs
+// less than an allocation of its own.
+constexpr size_t kMinOutOfLineChunkSize = 64 * 1024;
+
+}  // namespace
+
 // static
 bool V8ScriptValueSerializer::ExtractTransferable(
     v8::Isolate* isolate,
@@ -221,7 +229,9 @@ V8ScriptValueSerializer::V8ScriptValueSerializer(ScriptState* script_state,
       transferables_(options.transferables),
       blob_info_array_(options.blob_info),
       wasm_policy_(options.wasm_policy),
-      for_storage_(options.for_storage == SerializedScriptValue::kForStorage) {}
+      for_storage_(options.for_storage == SerializedScriptValue::kForStorage),
+      use_out_of_line_chunks_(options.use_out_of_line_chunks &&
+                              !for_storage_) {}
 
 scoped_refptr<SerializedScriptValue> V8ScriptValueSerializer::Serialize(
     v8::Local<v8::Value> value,
@@ -488,6 +498,14 @@ bool V8ScriptValueSerializer::WriteDOMObject(ScriptWrappable* wrappable,
   }
   if (wrapper_type_info == V8ImageData::GetWrapperTypeInfo()) {
     ImageData* image_data = wrappable->ToImpl<ImageData>();
+    base::span<const uint8_t> pixels;
+    if (!image_data->IsBufferBaseDetached()) {
+      SkPixmap image_data_pixmap = image_data->GetSkPixmap();
+      pixels = base::make_span(
+          static_cast<const uint8_t*>(image_data_pixmap.addr()),
+          image_data_pixmap.computeByteSize());
+    }
+    absl::optional<uint32_t> chunk_index = WriteOutOfLineChunk(pixels);
     WriteTag(kImageDataTag);
     SerializedImageDataSettings settings(
         image_data->GetPredefinedColorSpace(),
@@ -496,17 +514,16 @@ bool V8ScriptValueSerializer::WriteDOMObject(ScriptWrappable* wrappable,
     WriteUint32Enum(settings.GetSerializedColorSpace());
     WriteUint32Enum(ImageSerializationTag::kImageDataStorageFormatTag);
     WriteUint32Enum(settings.GetSerializedImageDataStorageFormat());
+    if (chunk_index) {
+      WriteUint32Enum(ImageSerializationTag::kOutOfLineChunkTag);
+      WriteUint32(*chunk_index);
+    }
     WriteUint32Enum(ImageSerializationTag::kEndTag);
     WriteUint32(image_data->width());
     WriteUint32(image_data->height());
-    if (image_data->IsBufferBaseDetached()) {
-      WriteUint64(0u);
-    } else {
-      SkPixmap image_data_pixmap = image_data->GetSkPixmap();
-      size_t pixel_buffer_length = image_data_pixmap.computeByteSize();
-      WriteUint64(base::strict_cast<uint64_t>(pixel_buffer_length));
-      WriteRawBytes(image_data_pixmap.addr(), pixel_buffer_length);
-    }
+    WriteUint64(base::strict_cast<uint64_t>(pixels.size()));
+    if (!chunk_index)
+      WriteRawBytes(pixels.data(), pixels.size());
     return true;
   }
   if (wrapper_type_info == V8DOMPoint::GetWrapperTypeInfo()) {
@@ -929,6 +946,24 @@ v8::Maybe<uint32_t> V8ScriptValueSerializer::GetWasmModuleTransferId(
   return v8::Nothing<uint32_t>();
 }
 
+absl::optional<uint32_t> V8ScriptValueSerializer::WriteOutOfLineChunk(
+    base::span<const uint8_t> data) {
+  if (!use_out_of_line_chunks_ || data.size() < kMinOutOfLineChunkSize)
+    return absl::nullopt;
+
+  // The chunk is allocated with the exact size, so that large data is copied
+  // only once, unlike the wire data which is reallocated as it grows.
+  ArrayBufferContents chunk(data.size(), 1, ArrayBufferContents::kNotShared,
+                            ArrayBufferContents::kDontInitialize);
+  if (!chunk.IsValid())
+    return absl::nullopt;
+  memcpy(chunk.Data(), data.data(), data.size());
+
+  auto& chunks = serialized_script_value_->out_of_line_chunks_;
+  chunks.push_back(std::move(chunk));
+  return chunks.size() - 1;
+}
+
 void* V8ScriptValueSerializer::ReallocateBufferMemory(void* old_buffer,
                                                       size_t size,
                                                       size_t* actual_size) {
@@ -5,8 +5,10 @@
 #ifndef THIRD_PARTY_BLINK_RENDERER_BINDINGS_CORE_V8_SERIALIZATION_V8_SCRIPT_VALUE_SERIALIZER_H_
 #define THIRD_PARTY_BLINK_RENDERER_BINDINGS_CORE_V8_SERIALIZATION_V8_SCRIPT_VALUE_SERIALIZER_H_
 
+#include "base/containers/span.h"
 #include "base/dcheck_is_on.h"
 #include "base/memory/scoped_refptr.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/renderer/bindings/core/v8/serialization/serialization_tag.h"
 #include "third_party/blink/renderer/bindings/core/v8/serialization/serialized_color_params.h"
 #include "third_party/blink/renderer/bindings/core/v8/serialization/serialized_script_value.h"
@@ -86,6 +88,12 @@ class CORE_EXPORT V8ScriptValueSerializer
     return serialized_script_value_.get();
   }
 
+  // Copies |data| to a new out-of-line chunk of the SerializedScriptValue and
+  // returns the index of the chunk, if out-of-line chunks are allowed and
+  // |data| is large enough to be worth it.  Otherwise returns absl::nullopt,
+  // and |data| should be written inline.
+  absl::optional<uint32_t> WriteOutOfLineChunk(base::span<const uint8_t> data);
+
   bool IsForStorage() const { return for_storage_; }
 
  private:
@@ -128,6 +136,7 @@ class CORE_EXPORT V8ScriptValueSerializer
   SharedArrayBufferArray shared_array_buffers_;
   Options::WasmSerializationPolicy wasm_policy_;
   bool for_storage_ = false;
+  bool use_out_of_line_chunks_ = false;
 #if DCHECK_IS_ON()
   bool serialize_invoked_ = false;
 #endif
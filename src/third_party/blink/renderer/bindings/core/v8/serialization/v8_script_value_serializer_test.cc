@@ -798,6 +798,56 @@ TEST(V8ScriptValueSerializerTest, RoundTripDetachedImageData) {
   EXPECT_FALSE(V8ImageData::HasInstance(result, scope.GetIsolate()));
 }
 
+TEST(V8ScriptValueSerializerTest, RoundTripImageDataInOutOfLineChunk) {
+  // The pixels of a large ImageData are kept out of the wire data if allowed,
+  // and the value can still be deserialized multiple times.
+  V8TestingScope scope;
+  ImageData* image_data = ImageData::ValidateAndCreate(
+      256, 256, absl::nullopt, nullptr, ImageData::ValidateAndCreateParams(),
+      ASSERT_NO_EXCEPTION);
+  SkPixmap pm = image_data->GetSkPixmap();
+  pm.writable_addr32(0, 0)[0] = 200u;
+  pm.writable_addr32(255, 255)[0] = 100u;
+  v8::Local<v8::Value> wrapper =
+      ToV8(image_data, scope.GetContext()->Global(), scope.GetIsolate());
+
+  V8ScriptValueSerializer::Options options;
+  options.use_out_of_line_chunks = true;
+  scoped_refptr<SerializedScriptValue> serialized_script_value =
+      V8ScriptValueSerializer(scope.GetScriptState(), options)
+          .Serialize(wrapper, ASSERT_NO_EXCEPTION);
+  ASSERT_TRUE(serialized_script_value);
+  ASSERT_EQ(1u, serialized_script_value->OutOfLineChunks().size());
+  EXPECT_EQ(pm.computeByteSize(),
+            serialized_script_value->OutOfLineChunks()[0].DataLength());
+  EXPECT_LT(serialized_script_value->DataLengthInBytes(), 64u);
+
+  UnpackedSerializedScriptValue* unpacked =
+      SerializedScriptValue::Unpack(std::move(serialized_script_value));
+  for (int i = 0; i < 2; ++i) {
+    v8::Local<v8::Value> result =
+        V8ScriptValueDeserializer(scope.GetScriptState(), unpacked)
+            .Deserialize();
+    ASSERT_TRUE(V8ImageData::HasInstance(result, scope.GetIsolate()));
+    ImageData* new_image_data = V8ImageData::ToImpl(result.As<v8::Object>());
+    EXPECT_NE(image_data, new_image_data);
+    EXPECT_EQ(image_data->Size(), new_image_data->Size());
+    SkPixmap new_pm = new_image_data->GetSkPixmap();
+    EXPECT_EQ(200u, new_pm.addr32(0, 0)[0]);
+    EXPECT_EQ(100u, new_pm.addr32(255, 255)[0]);
+  }
+
+  // Values for storage never use out-of-line chunks.
+  options.for_storage = SerializedScriptValue::kForStorage;
+  serialized_script_value =
+      V8ScriptValueSerializer(scope.GetScriptState(), options)
+          .Serialize(wrapper, ASSERT_NO_EXCEPTION);
+  ASSERT_TRUE(serialized_script_value);
+  EXPECT_TRUE(serialized_script_value->OutOfLineChunks().IsEmpty());
+  EXPECT_GT(serialized_script_value->DataLengthInBytes(),
+            pm.computeByteSize());
+}
+
 TEST(V8ScriptValueSerializerTest, RoundTripImageDataWithColorSpaceInfo) {
   // ImageData objects with color space information should serialize and
   // deserialize correctly.
@@ -895,6 +945,14 @@ TEST(V8ScriptValueSerializerTest, InvalidImageDataDecodeV18) {
     EXPECT_TRUE(
         V8ScriptValueDeserializer(script_state, input).Deserialize()->IsNull());
   }
+  {
+    // Reference to an out-of-line chunk which does not exist.
+    scoped_refptr<SerializedScriptValue> input =
+        SerializedValue({0xff, 0x14, 0xff, 0x0d, 0x5c, 0x23, 0x07, 0x00, 0x00,
+                         0x01, 0x01, 0x04, 0x00, 0x00});
+    EXPECT_TRUE(
+        V8ScriptValueDeserializer(script_state, input).Deserialize()->IsNull());
+  }
 }
 
 MessagePort* MakeMessagePort(ExecutionContext* execution_context,
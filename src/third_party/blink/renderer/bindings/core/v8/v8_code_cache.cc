@@ -4,6 +4,8 @@
 
 #include "third_party/blink/renderer/bindings/core/v8/v8_code_cache.h"
 
+#include <algorithm>
+
 #include "build/build_config.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/public/mojom/v8_cache_options.mojom-blink.h"
@@ -11,6 +13,7 @@
 #include "third_party/blink/renderer/bindings/core/v8/module_record.h"
 #include "third_party/blink/renderer/bindings/core/v8/referrer_script_info.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_core.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_code_cache_statistics.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_initializer.h"
 #include "third_party/blink/renderer/core/inspector/inspector_trace_events.h"
 #include "third_party/blink/renderer/core/probe/core_probes.h"
@@ -23,6 +26,15 @@
 
 namespace blink {
 
+namespace features {
+
+const base::Feature kV8CodeCacheEagerProduce{"V8CodeCacheEagerProduce",
+                                             base::FEATURE_DISABLED_BY_DEFAULT};
+const base::FeatureParam<int> kV8CodeCacheEagerProduceExecutions{
+    &kV8CodeCacheEagerProduce, "executions", 2};
+
+}  // namespace features
+
 namespace {
 
 enum CacheTagKind { kCacheTagCode = 0, kCacheTagTimeStamp = 1, kCacheTagLast };
@@ -45,21 +57,37 @@ uint32_t CacheTag(CacheTagKind kind, const String& encoding) {
          (encoding.IsNull() ? 0 : StringHash::GetHash(encoding));
 }
 
-// Check previously stored timestamp.
-bool IsResourceHotForCaching(const SingleCachedMetadataHandler* cache_handler) {
+// The timestamp is stored together with the number of the executions of the
+// script without the code cache so far.  The timestamps stored before the
+// count was added hold the time only, and count as one execution.
+struct TimeStampData {
+  uint64_t time_stamp_ms;
+  uint64_t execution_count;
+};
+
+// Check previously stored timestamp.  Returns the number of the executions
+// recorded with it, or 0 if there is no timestamp or it is too old.
+uint64_t GetHotExecutionCount(
+    const SingleCachedMetadataHandler* cache_handler) {
   static constexpr base::TimeDelta kHotHours = base::Hours(72);
   scoped_refptr<CachedMetadata> cached_metadata =
       cache_handler->GetCachedMetadata(
           V8CodeCache::TagForTimeStamp(cache_handler));
   if (!cached_metadata)
-    return false;
-  uint64_t time_stamp_ms;
-  const uint32_t size = sizeof(time_stamp_ms);
-  DCHECK_EQ(cached_metadata->size(), size);
-  memcpy(&time_stamp_ms, cached_metadata->Data(), size);
+    return 0;
+  TimeStampData data = {0, 1};
+  const uint32_t size = cached_metadata->size();
+  DCHECK(size == sizeof(data.time_stamp_ms) || size == sizeof(data));
+  memcpy(&data, cached_metadata->Data(), std::min<size_t>(size, sizeof(data)));
   base::TimeTicks time_stamp =
-      base::TimeTicks() + base::Milliseconds(time_stamp_ms);
-  return (base::TimeTicks::Now() - time_stamp) < kHotHours;
+      base::TimeTicks() + base::Milliseconds(data.time_stamp_ms);
+  if ((base::TimeTicks::Now() - time_stamp) >= kHotHours)
+    return 0;
+  return data.execution_count;
+}
+
+bool IsResourceHotForCaching(const SingleCachedMetadataHandler* cache_handler) {
+  return GetHotExecutionCount(cache_handler) > 0;
 }
 
 }  // namespace
@@ -104,9 +132,41 @@ std::tuple<v8::ScriptCompiler::CompileOptions,
            v8::ScriptCompiler::NoCacheReason>
 V8CodeCache::GetCompileOptions(mojom::blink::V8CacheOptions cache_options,
                                const ClassicScript& classic_script) {
-  return GetCompileOptions(cache_options, classic_script.CacheHandler(),
-                           classic_script.SourceText().length(),
-                           classic_script.SourceLocationType());
+  const SingleCachedMetadataHandler* cache_handler =
+      classic_script.CacheHandler();
+  auto compile_options =
+      GetCompileOptions(cache_options, cache_handler,
+                        classic_script.SourceText().length(),
+                        classic_script.SourceLocationType());
+
+  // The eager policy applies only to the scripts that would set the timestamp
+  // or produce the code cache after a lazy compile, i.e. cacheable scripts
+  // without the code cache.
+  if (std::get<0>(compile_options) != v8::ScriptCompiler::kNoCompileOptions ||
+      std::get<1>(compile_options) == ProduceCacheOptions::kNoProduceCache ||
+      !base::FeatureList::IsEnabled(features::kV8CodeCacheEagerProduce)) {
+    return compile_options;
+  }
+
+  // The executions are counted in the cache handler, so that the count holds
+  // across processes.  The scripts that skip the heat check produce the code
+  // cache at the first execution anyway.
+  uint64_t executions_to_produce = 1;
+  if ((cache_options == mojom::blink::V8CacheOptions::kDefault ||
+       cache_options == mojom::blink::V8CacheOptions::kCode) &&
+      !cache_handler->IsServedFromCacheStorage()) {
+    executions_to_produce = static_cast<uint64_t>(
+        std::max(1, features::kV8CodeCacheEagerProduceExecutions.Get()));
+  }
+  const uint64_t execution = GetHotExecutionCount(cache_handler) + 1;
+  if (execution < executions_to_produce) {
+    return std::make_tuple(v8::ScriptCompiler::kNoCompileOptions,
+                           ProduceCacheOptions::kSetTimeStamp,
+                           v8::ScriptCompiler::kNoCacheBecauseCacheTooCold);
+  }
+  return std::make_tuple(
+      v8::ScriptCompiler::kEagerCompile, ProduceCacheOptions::kProduceCodeCache,
+      v8::ScriptCompiler::kNoCacheBecauseDeferredProduceCodeCache);
 }
 
 std::tuple<v8::ScriptCompiler::CompileOptions,
@@ -223,6 +283,10 @@ static void ProduceCacheInternal(
   switch (produce_cache_options) {
     case V8CodeCache::ProduceCacheOptions::kSetTimeStamp:
       V8CodeCache::SetCacheTimeStamp(code_cache_host, cache_handler);
+      if (V8CodeCacheStatistics::IsEnabled()) {
+        V8CodeCacheStatistics::Get().RecordProduceCache(
+            source_url, produce_cache_options, 0);
+      }
       break;
     case V8CodeCache::ProduceCacheOptions::kProduceCodeCache: {
       // TODO(crbug.com/938269): Investigate why this can be empty here.
@@ -253,6 +317,11 @@ static void ProduceCacheInternal(
             code_cache_host, V8CodeCache::TagForCodeCache(cache_handler), data,
             length);
       }
+      if (V8CodeCacheStatistics::IsEnabled()) {
+        V8CodeCacheStatistics::Get().RecordProduceCache(
+            source_url, produce_cache_options,
+            cached_data ? cached_data->length : 0);
+      }
 
       TRACE_EVENT_END1(kTraceEventCategoryGroup, trace_name, "data",
                        [&](perfetto::TracedValue context) {
@@ -305,16 +374,20 @@ uint32_t V8CodeCache::TagForTimeStamp(
   return CacheTag(kCacheTagTimeStamp, cache_handler->Encoding());
 }
 
-// Store a timestamp to the cache as hint.
+// Store a timestamp to the cache as hint, and count the execution.
 void V8CodeCache::SetCacheTimeStamp(
     CodeCacheHost* code_cache_host,
     SingleCachedMetadataHandler* cache_handler) {
-  uint64_t now_ms = base::TimeTicks::Now().since_origin().InMilliseconds();
+  TimeStampData data = {
+      static_cast<uint64_t>(
+          base::TimeTicks::Now().since_origin().InMilliseconds()),
+      GetHotExecutionCount(cache_handler) + 1};
   cache_handler->ClearCachedMetadata(code_cache_host,
                                      CachedMetadataHandler::kClearLocally);
-  cache_handler->SetCachedMetadata(
-      code_cache_host, TagForTimeStamp(cache_handler),
-      reinterpret_cast<uint8_t*>(&now_ms), sizeof(now_ms));
+  cache_handler->SetCachedMetadata(code_cache_host,
+                                   TagForTimeStamp(cache_handler),
+                                   reinterpret_cast<uint8_t*>(&data),
+                                   sizeof(data));
 }
 
 // static
@@ -377,6 +450,10 @@ scoped_refptr<CachedMetadata> V8CodeCache::GenerateFullCodeCache(
       cached_metadata =
           CachedMetadata::Create(CacheTag(kCacheTagCode, encoding.GetName()),
                                  cached_data->data, cached_data->length);
+      if (V8CodeCacheStatistics::IsEnabled()) {
+        V8CodeCacheStatistics::Get().RecordFullCodeCacheGenerated(
+            source_url, cached_data->length);
+      }
     }
 
     TRACE_EVENT_END1(kTraceEventCategoryGroup, "v8.produceCache", "data",
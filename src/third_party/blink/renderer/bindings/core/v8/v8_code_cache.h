@@ -7,6 +7,8 @@
 
 #include <stdint.h>
 
+#include "base/feature_list.h"
+#include "base/metrics/field_trial_params.h"
 #include "third_party/blink/public/mojom/v8_cache_options.mojom-blink.h"
 #include "third_party/blink/renderer/bindings/core/v8/script_source_location_type.h"
 #include "third_party/blink/renderer/core/core_export.h"
@@ -33,6 +35,20 @@ namespace mojom {
 class CodeCacheHost;
 }
 
+namespace features {
+
+// Opt-in policy that compiles a classic script eagerly and produces its full
+// code cache at the |kV8CodeCacheEagerProduceExecutions|-th execution of the
+// script without the code cache, instead of producing the code cache from the
+// lazily compiled script at the second one.  The executions are counted along
+// with the timestamp in the script's cache handler, and start over when the
+// timestamp gets too old.
+CORE_EXPORT extern const base::Feature kV8CodeCacheEagerProduce;
+CORE_EXPORT extern const base::FeatureParam<int>
+    kV8CodeCacheEagerProduceExecutions;
+
+}  // namespace features
+
 class CORE_EXPORT V8CodeCache final {
   STATIC_ONLY(V8CodeCache);
 
@@ -50,6 +66,8 @@ class CORE_EXPORT V8CodeCache final {
 
   static uint32_t TagForCodeCache(const SingleCachedMetadataHandler*);
   static uint32_t TagForTimeStamp(const SingleCachedMetadataHandler*);
+  // Stores the current time and the number of the executions of the script
+  // without the code cache so far, counting this one.
   static void SetCacheTimeStamp(CodeCacheHost*, SingleCachedMetadataHandler*);
 
   // Returns true iff the SingleCachedMetadataHandler contains a code cache
@@ -0,0 +1,270 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/bindings/core/v8/v8_code_cache_statistics.h"
+
+#include "third_party/blink/renderer/platform/instrumentation/tracing/trace_event.h"
+#include "third_party/blink/renderer/platform/weborigin/kurl.h"
+#include "third_party/blink/renderer/platform/weborigin/security_origin.h"
+#include "third_party/blink/renderer/platform/wtf/std_lib_extras.h"
+#include "third_party/perfetto/include/perfetto/tracing/traced_value.h"
+
+namespace blink {
+
+namespace features {
+
+const base::Feature kV8CodeCacheStatistics{"V8CodeCacheStatistics",
+                                           base::FEATURE_DISABLED_BY_DEFAULT};
+
+}  // namespace features
+
+namespace {
+
+void AddCompile(V8CodeCacheStatistics::Counters& counters,
+                const V8CodeCacheStatistics::CompileResult& result,
+                base::TimeDelta compile_time_saved) {
+  ++counters.compiles;
+  if (result.consumed_cache) {
+    if (result.cache_rejected) {
+      ++counters.cache_rejects;
+    } else {
+      ++counters.cache_hits;
+      counters.bytes_consumed += result.consumed_cache_size;
+    }
+  } else {
+    ++counters.cache_misses;
+    size_t reason = static_cast<size_t>(result.no_cache_reason);
+    if (reason < counters.cache_misses_by_reason.size())
+      ++counters.cache_misses_by_reason[reason];
+  }
+  if (result.streamed) {
+    ++counters.streamed;
+  } else if (result.not_streaming_reason !=
+             ScriptStreamer::NotStreamingReason::kInvalid) {
+    ++counters.not_streamed_by_reason[static_cast<size_t>(
+        result.not_streaming_reason)];
+  }
+  counters.compile_time += result.compile_time;
+  counters.compile_time_saved += compile_time_saved;
+}
+
+void AddProduce(V8CodeCacheStatistics::Counters& counters,
+                V8CodeCache::ProduceCacheOptions produce_cache_options,
+                size_t produced_size,
+                bool is_full_code_cache) {
+  switch (produce_cache_options) {
+    case V8CodeCache::ProduceCacheOptions::kSetTimeStamp:
+      ++counters.timestamps_set;
+      break;
+    case V8CodeCache::ProduceCacheOptions::kProduceCodeCache:
+      // V8 may fail to create the code cache.
+      if (!produced_size)
+        break;
+      ++counters.caches_produced;
+      if (is_full_code_cache)
+        ++counters.full_caches_produced;
+      counters.bytes_produced += produced_size;
+      break;
+    case V8CodeCache::ProduceCacheOptions::kNoProduceCache:
+      break;
+  }
+}
+
+void WriteCountsIntoTrace(perfetto::TracedValue context,
+                          const uint64_t* counts,
+                          size_t size) {
+  auto array = std::move(context).WriteArray();
+  for (size_t i = 0; i < size; ++i)
+    array.Append(counts[i]);
+}
+
+}  // namespace
+
+void V8CodeCacheStatistics::Counters::WriteIntoTrace(
+    perfetto::TracedValue context) const {
+  auto dict = std::move(context).WriteDictionary();
+  dict.Add("compiles", compiles);
+  dict.Add("cacheHits", cache_hits);
+  dict.Add("cacheRejects", cache_rejects);
+  dict.Add("cacheMisses", cache_misses);
+  // Indexed by v8::ScriptCompiler::NoCacheReason.
+  WriteCountsIntoTrace(dict.AddItem("cacheMissesByReason"),
+                       cache_misses_by_reason.data(),
+                       cache_misses_by_reason.size());
+  dict.Add("streamed", streamed);
+  // Indexed by ScriptStreamer::NotStreamingReason.
+  WriteCountsIntoTrace(dict.AddItem("notStreamedByReason"),
+                       not_streamed_by_reason.data(),
+                       not_streamed_by_reason.size());
+  dict.Add("timestampsSet", timestamps_set);
+  dict.Add("cachesProduced", caches_produced);
+  dict.Add("fullCachesProduced", full_caches_produced);
+  dict.Add("bytesConsumed", bytes_consumed);
+  dict.Add("bytesProduced", bytes_produced);
+  dict.Add("compileTimeMs", compile_time.InMillisecondsF());
+  dict.Add("compileTimeSavedMs", compile_time_saved.InMillisecondsF());
+}
+
+// static
+bool V8CodeCacheStatistics::IsEnabled() {
+  return base::FeatureList::IsEnabled(features::kV8CodeCacheStatistics);
+}
+
+// static
+V8CodeCacheStatistics& V8CodeCacheStatistics::Get() {
+  DEFINE_THREAD_SAFE_STATIC_LOCAL(V8CodeCacheStatistics, statistics, ());
+  return statistics;
+}
+
+void V8CodeCacheStatistics::RecordCompile(const KURL& script_url,
+                                          const CompileResult& result) {
+  DCHECK(IsEnabled());
+  const String origin = SecurityOrigin::Create(script_url)->ToString();
+  {
+    base::AutoLock locker(lock_);
+    const bool cache_hit = result.consumed_cache && !result.cache_rejected;
+    base::TimeDelta compile_time_saved;
+    if (ScriptEntry* entry = EnsureScriptEntry(script_url.GetString())) {
+      if (cache_hit && !entry->last_uncached_compile_time.is_zero() &&
+          entry->last_uncached_compile_time > result.compile_time) {
+        compile_time_saved =
+            entry->last_uncached_compile_time - result.compile_time;
+      }
+      // The main-thread compile time of streamed scripts does not include the
+      // parse on the background thread, so it's not a baseline.
+      if (!cache_hit && !result.streamed)
+        entry->last_uncached_compile_time = result.compile_time;
+      entry->last_compile_was_eager =
+          result.compile_options == v8::ScriptCompiler::kEagerCompile;
+      AddCompile(entry->counters, result, compile_time_saved);
+    }
+    if (Counters* counters = EnsureOriginCounters(origin))
+      AddCompile(*counters, result, compile_time_saved);
+    AddCompile(total_, result, compile_time_saved);
+  }
+  TraceUpdate(script_url, origin);
+}
+
+void V8CodeCacheStatistics::RecordProduceCache(
+    const KURL& script_url,
+    V8CodeCache::ProduceCacheOptions produce_cache_options,
+    size_t produced_size) {
+  RecordProduce(script_url, produce_cache_options, produced_size, false);
+}
+
+void V8CodeCacheStatistics::RecordFullCodeCacheGenerated(
+    const KURL& script_url,
+    size_t produced_size) {
+  RecordProduce(script_url, V8CodeCache::ProduceCacheOptions::kProduceCodeCache,
+                produced_size, true);
+}
+
+void V8CodeCacheStatistics::RecordProduce(
+    const KURL& script_url,
+    V8CodeCache::ProduceCacheOptions produce_cache_options,
+    size_t produced_size,
+    bool is_full_code_cache) {
+  DCHECK(IsEnabled());
+  if (produce_cache_options ==
+      V8CodeCache::ProduceCacheOptions::kNoProduceCache) {
+    return;
+  }
+
+  const String origin = SecurityOrigin::Create(script_url)->ToString();
+  {
+    base::AutoLock locker(lock_);
+    ScriptEntry* entry = EnsureScriptEntry(script_url.GetString());
+    if (entry) {
+      // The code cache after an eager compile contains all functions.
+      is_full_code_cache |= entry->last_compile_was_eager;
+      AddProduce(entry->counters, produce_cache_options, produced_size,
+                 is_full_code_cache);
+    }
+    if (Counters* counters = EnsureOriginCounters(origin)) {
+      AddProduce(*counters, produce_cache_options, produced_size,
+                 is_full_code_cache);
+    }
+    AddProduce(total_, produce_cache_options, produced_size,
+               is_full_code_cache);
+  }
+  TraceUpdate(script_url, origin);
+}
+
+V8CodeCacheStatistics::Counters V8CodeCacheStatistics::ForScript(
+    const KURL& script_url) const {
+  const String& key = script_url.GetString();
+  if (key.IsNull())
+    return Counters();
+  base::AutoLock locker(lock_);
+  auto it = scripts_.find(key);
+  return it == scripts_.end() ? Counters() : it->value.counters;
+}
+
+V8CodeCacheStatistics::Counters V8CodeCacheStatistics::ForOrigin(
+    const KURL& url) const {
+  return ForOriginString(SecurityOrigin::Create(url)->ToString());
+}
+
+V8CodeCacheStatistics::Counters V8CodeCacheStatistics::ForOriginString(
+    const String& origin) const {
+  base::AutoLock locker(lock_);
+  auto it = origins_.find(origin);
+  return it == origins_.end() ? Counters() : it->value;
+}
+
+V8CodeCacheStatistics::Counters V8CodeCacheStatistics::Total() const {
+  base::AutoLock locker(lock_);
+  return total_;
+}
+
+void V8CodeCacheStatistics::ResetForTesting() {
+  base::AutoLock locker(lock_);
+  scripts_.clear();
+  origins_.clear();
+  total_ = Counters();
+}
+
+V8CodeCacheStatistics::ScriptEntry* V8CodeCacheStatistics::EnsureScriptEntry(
+    const String& script_url) {
+  if (script_url.IsNull())
+    return nullptr;
+  auto it = scripts_.find(script_url);
+  if (it != scripts_.end())
+    return &it->value;
+  if (scripts_.size() >= kMaxEntries)
+    return nullptr;
+  return &scripts_.insert(script_url.IsolatedCopy(), ScriptEntry())
+              .stored_value->value;
+}
+
+V8CodeCacheStatistics::Counters* V8CodeCacheStatistics::EnsureOriginCounters(
+    const String& origin) {
+  auto it = origins_.find(origin);
+  if (it != origins_.end())
+    return &it->value;
+  if (origins_.size() >= kMaxEntries)
+    return nullptr;
+  return &origins_.insert(origin.IsolatedCopy(), Counters())
+              .stored_value->value;
+}
+
+void V8CodeCacheStatistics::TraceUpdate(const KURL& script_url,
+                                        const String& origin) const {
+  bool enabled;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED(TRACE_DISABLED_BY_DEFAULT("v8.compile"),
+                                     &enabled);
+  if (!enabled)
+    return;
+
+  Counters script_counters = ForScript(script_url);
+  Counters origin_counters = ForOriginString(origin);
+  Counters total = Total();
+  TRACE_EVENT_INSTANT(TRACE_DISABLED_BY_DEFAULT("v8.compile"),
+                      "V8CodeCacheStatistics", "url",
+                      script_url.GetString().Utf8(), "origin", origin.Utf8(),
+                      "script", script_counters, "originTotal",
+                      origin_counters, "total", total);
+}
+
+}  // namespace blink
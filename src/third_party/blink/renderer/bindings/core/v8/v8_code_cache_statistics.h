@@ -0,0 +1,183 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_RENDERER_BINDINGS_CORE_V8_V8_CODE_CACHE_STATISTICS_H_
+#define THIRD_PARTY_BLINK_RENDERER_BINDINGS_CORE_V8_V8_CODE_CACHE_STATISTICS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+
+#include "base/feature_list.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+#include "third_party/blink/renderer/bindings/core/v8/script_streamer.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_code_cache.h"
+#include "third_party/blink/renderer/core/core_export.h"
+#include "third_party/blink/renderer/platform/wtf/allocator/allocator.h"
+#include "third_party/blink/renderer/platform/wtf/hash_map.h"
+#include "third_party/blink/renderer/platform/wtf/text/string_hash.h"
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+#include "third_party/perfetto/include/perfetto/tracing/traced_value_forward.h"
+#include "v8/include/v8.h"
+
+namespace blink {
+
+class KURL;
+
+namespace features {
+
+// Enables V8CodeCacheStatistics.  Without it, compiles and code cache
+// productions are not recorded, and the trace event is not emitted.
+CORE_EXPORT extern const base::Feature kV8CodeCacheStatistics;
+
+}  // namespace features
+
+// Aggregates how the scripts compiled in this process used the V8 code cache
+// and script streaming, per script, per origin and in total, so that it's
+// possible to tell why scripts miss the code cache and how much main-thread
+// compile time the code cache saves.  The statistics are shared by all
+// threads.  Nothing is recorded unless |features::kV8CodeCacheStatistics| is
+// enabled, and callers check IsEnabled() before collecting what to record.
+//
+// Every update is reported as a trace event "V8CodeCacheStatistics" in the
+// "disabled-by-default-v8.compile" category.  Tests read the statistics
+// through ForScript, ForOrigin and Total.
+class CORE_EXPORT V8CodeCacheStatistics final {
+  USING_FAST_MALLOC(V8CodeCacheStatistics);
+
+ public:
+  // v8::ScriptCompiler::NoCacheReason has no kMaxValue.
+  static constexpr size_t kNoCacheReasonCount =
+      v8::ScriptCompiler::kNoCacheBecauseDeferredProduceCodeCache + 1;
+  static constexpr size_t kNotStreamingReasonCount =
+      static_cast<size_t>(ScriptStreamer::NotStreamingReason::kMaxValue) + 1;
+
+  // Scripts and origins beyond this number are counted only in the total.
+  static constexpr wtf_size_t kMaxEntries = 1024;
+
+  struct CORE_EXPORT Counters {
+    DISALLOW_NEW();
+
+   public:
+    void WriteIntoTrace(perfetto::TracedValue context) const;
+
+    // Number of compiles, including all of the compiles counted below.
+    uint64_t compiles = 0;
+    // Compiles that consumed the code cache, and the ones where V8 rejected
+    // the code cache.
+    uint64_t cache_hits = 0;
+    uint64_t cache_rejects = 0;
+    // Compiles that did not try to consume the code cache, in total and by
+    // v8::ScriptCompiler::NoCacheReason.
+    uint64_t cache_misses = 0;
+    std::array<uint64_t, kNoCacheReasonCount> cache_misses_by_reason = {};
+    // Compiles of streamed scripts, and of the other scripts by
+    // ScriptStreamer::NotStreamingReason.
+    uint64_t streamed = 0;
+    std::array<uint64_t, kNotStreamingReasonCount> not_streamed_by_reason = {};
+    // Timestamps stored instead of the code cache at the first run.
+    uint64_t timestamps_set = 0;
+    // Code caches produced, and the ones of them produced from eagerly
+    // compiled scripts, i.e. full code caches.
+    uint64_t caches_produced = 0;
+    uint64_t full_caches_produced = 0;
+    uint64_t bytes_consumed = 0;
+    uint64_t bytes_produced = 0;
+    base::TimeDelta compile_time;
+    // How much faster the cache hits compiled than the last compile of the
+    // same script without the code cache in this process.  Cache hits of
+    // scripts that have not been compiled without the code cache in this
+    // process don't count.
+    base::TimeDelta compile_time_saved;
+  };
+
+  // What a compile of a script did, recorded by RecordCompile.
+  struct CompileResult {
+    STACK_ALLOCATED();
+
+   public:
+    v8::ScriptCompiler::CompileOptions compile_options =
+        v8::ScriptCompiler::kNoCompileOptions;
+    v8::ScriptCompiler::NoCacheReason no_cache_reason =
+        v8::ScriptCompiler::kNoCacheNoReason;
+    // Whether the code cache was given to V8, and if so, its size and whether
+    // V8 rejected it.
+    bool consumed_cache = false;
+    size_t consumed_cache_size = 0;
+    bool cache_rejected = false;
+    bool streamed = false;
+    ScriptStreamer::NotStreamingReason not_streaming_reason =
+        ScriptStreamer::NotStreamingReason::kInvalid;
+    base::TimeDelta compile_time;
+  };
+
+  static bool IsEnabled();
+  static V8CodeCacheStatistics& Get();
+
+  V8CodeCacheStatistics(const V8CodeCacheStatistics&) = delete;
+  V8CodeCacheStatistics& operator=(const V8CodeCacheStatistics&) = delete;
+
+  void RecordCompile(const KURL& script_url, const CompileResult&);
+  // Records what V8CodeCache::ProduceCache did for |script_url|.  A produced
+  // code cache is counted as a full code cache if the last compile of the
+  // script was eager.
+  void RecordProduceCache(const KURL& script_url,
+                          V8CodeCache::ProduceCacheOptions,
+                          size_t produced_size);
+  // Records a code cache produced by V8CodeCache::GenerateFullCodeCache.
+  void RecordFullCodeCacheGenerated(const KURL& script_url,
+                                    size_t produced_size);
+
+  Counters ForScript(const KURL& script_url) const;
+  // Returns the counters of the origin of |url|.
+  Counters ForOrigin(const KURL& url) const;
+  Counters Total() const;
+
+  // Forgets all the statistics, so that tests do not depend on the scripts
+  // that earlier tests in the same process compiled.
+  void ResetForTesting();
+
+ private:
+  struct ScriptEntry {
+    DISALLOW_NEW();
+
+   public:
+    Counters counters;
+    bool last_compile_was_eager = false;
+    base::TimeDelta last_uncached_compile_time;
+  };
+
+  V8CodeCacheStatistics() = default;
+
+  void RecordProduce(const KURL& script_url,
+                     V8CodeCache::ProduceCacheOptions,
+                     size_t produced_size,
+                     bool is_full_code_cache);
+
+  // Returns nullptr if there are too many entries already.
+  ScriptEntry* EnsureScriptEntry(const String& script_url)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  Counters* EnsureOriginCounters(const String& origin)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  Counters ForOriginString(const String& origin) const;
+
+  // Emits the trace event with the current counters of the script, its origin
+  // and the total, if the trace category is enabled.  |origin| is the origin
+  // of |script_url|, computed once per update by the caller.
+  void TraceUpdate(const KURL& script_url, const String& origin) const;
+
+  mutable base::Lock lock_;
+  // The keys are isolated copies, so that any thread can use them.
+  HashMap<String, ScriptEntry> scripts_ GUARDED_BY(lock_);
+  HashMap<String, Counters> origins_ GUARDED_BY(lock_);
+  Counters total_ GUARDED_BY(lock_);
+};
+
+}  // namespace blink
+
+#endif  // THIRD_PARTY_BLINK_RENDERER_BINDINGS_CORE_V8_V8_CODE_CACHE_STATISTICS_H_
@@ -26,6 +26,7 @@
 #include "third_party/blink/renderer/bindings/core/v8/v8_script_runner.h"
 
 #include "base/feature_list.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 #include "third_party/blink/public/common/features.h"
 #include "third_party/blink/public/mojom/v8_cache_options.mojom-blink.h"
@@ -37,6 +38,7 @@
 #include "third_party/blink/renderer/bindings/core/v8/script_streamer.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_core.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_code_cache.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_code_cache_statistics.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_initializer.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_throw_dom_exception.h"
 #include "third_party/blink/renderer/bindings/core/v8/worker_or_worklet_script_controller.h"
@@ -214,6 +216,29 @@ v8::MaybeLocal<v8::Script> CompileScriptInternal(
   return v8::MaybeLocal<v8::Script>();
 }
 
+void RecordCompileStatistics(
+    const KURL& script_url,
+    v8::ScriptCompiler::CompileOptions compile_options,
+    v8::ScriptCompiler::NoCacheReason no_cache_reason,
+    const absl::optional<inspector_compile_script_event::V8ConsumeCacheResult>&
+        cache_result,
+    ScriptStreamer* streamer,
+    ScriptStreamer::NotStreamingReason not_streaming_reason,
+    base::TimeTicks compile_start_time) {
+  V8CodeCacheStatistics::CompileResult result;
+  result.compile_options = compile_options;
+  result.no_cache_reason = no_cache_reason;
+  if (cache_result) {
+    result.consumed_cache = true;
+    result.consumed_cache_size = cache_result->cache_size;
+    result.cache_rejected = cache_result->rejected;
+  }
+  result.streamed = streamer;
+  result.not_streaming_reason = not_streaming_reason;
+  result.compile_time = base::TimeTicks::Now() - compile_start_time;
+  V8CodeCacheStatistics::Get().RecordCompile(script_url, result);
+}
+
 int GetMicrotasksScopeDepth(v8::Isolate* isolate,
                             v8::MicrotaskQueue* microtask_queue) {
   if (microtask_queue)
@@ -262,16 +287,28 @@ v8::MaybeLocal<v8::Script> V8ScriptRunner::CompileScript(
       false,  // is_module
       host_defined_options);
 
-  if (!*TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED(kTraceEventCategoryGroup)) {
+  // The consume result is needed for V8CodeCacheStatistics, too.
+  const bool record_statistics = V8CodeCacheStatistics::IsEnabled();
+  if (!record_statistics &&
+      !*TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED(kTraceEventCategoryGroup)) {
     return CompileScriptInternal(isolate, script_state, classic_script, origin,
                                  compile_options, no_cache_reason, nullptr);
   }
 
   absl::optional<inspector_compile_script_event::V8ConsumeCacheResult>
       cache_result;
+  const base::TimeTicks compile_start_time =
+      record_statistics ? base::TimeTicks::Now() : base::TimeTicks();
   v8::MaybeLocal<v8::Script> script =
       CompileScriptInternal(isolate, script_state, classic_script, origin,
                             compile_options, no_cache_reason, &cache_result);
+  if (record_statistics) {
+    RecordCompileStatistics(classic_script.SourceUrl(), compile_options,
+                            no_cache_reason, cache_result,
+                            classic_script.Streamer(),
+                            classic_script.NotStreamingReason(),
+                            compile_start_time);
+  }
   TRACE_EVENT_END1(
       kTraceEventCategoryGroup, "v8.compile", "data",
       [&](perfetto::TracedValue context) {
@@ -314,6 +351,9 @@ v8::MaybeLocal<v8::Module> V8ScriptRunner::CompileModule(
       cache_result;
   v8::MaybeLocal<v8::Module> script;
   ScriptStreamer* streamer = params.GetScriptStreamer();
+  const bool record_statistics = V8CodeCacheStatistics::IsEnabled();
+  const base::TimeTicks compile_start_time =
+      record_statistics ? base::TimeTicks::Now() : base::TimeTicks();
   if (streamer) {
     // Final compile call for a streamed compilation.
     // Streaming compilation may involve use of code cache.
@@ -370,6 +410,11 @@ v8::MaybeLocal<v8::Module> V8ScriptRunner::CompileModule(
       }
     }
   }
+  if (record_statistics) {
+    RecordCompileStatistics(params.SourceURL(), compile_options,
+                            no_cache_reason, cache_result, streamer,
+                            params.NotStreamingReason(), compile_start_time);
+  }
 
   TRACE_EVENT_END1(kTraceEventCategoryGroup, "v8.compileModule", "data",
                    [&](perfetto::TracedValue context) {
@@ -14,6 +14,7 @@
 #include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_core.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_binding_for_testing.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_code_cache.h"
+#include "third_party/blink/renderer/bindings/core/v8/v8_code_cache_statistics.h"
 #include "third_party/blink/renderer/core/execution_context/execution_context.h"
 #include "third_party/blink/renderer/core/loader/resource/script_resource.h"
 #include "third_party/blink/renderer/core/script/classic_script.h"
@@ -41,6 +42,9 @@ class V8ScriptRunnerTest : public testing::Test {
     // To trick various layers of caching, increment a counter for each
     // test and use it in Code() and Url().
     counter_++;
+    // The statistics are shared by the whole process, and the earlier tests
+    // may have filled the tables of the scripts and the origins.
+    V8CodeCacheStatistics::Get().ResetForTesting();
   }
 
   WTF::String Code() const {
@@ -608,6 +612,218 @@ TEST_F(V8ScriptRunnerTest, codeCacheWithFailedHashCheck) {
       cache_handler_4->GetCachedMetadata(TagForCodeCache(cache_handler_4)));
 }
 
+TEST_F(V8ScriptRunnerTest, codeCacheStatistics) {
+  feature_list_.InitAndEnableFeature(features::kV8CodeCacheStatistics);
+  V8TestingScope scope;
+  ClassicScript* classic_script = CreateScript(CreateResource(UTF8Encoding()));
+  const KURL url = classic_script->SourceUrl();
+  const V8CodeCacheStatistics& statistics = V8CodeCacheStatistics::Get();
+
+  // Cold run - should set the timestamp.
+  EXPECT_TRUE(CompileScript(scope.GetIsolate(), scope.GetScriptState(),
+                            *classic_script,
+                            mojom::blink::V8CacheOptions::kDefault));
+  V8CodeCacheStatistics::Counters counters = statistics.ForScript(url);
+  EXPECT_EQ(1u, counters.compiles);
+  EXPECT_EQ(1u, counters.cache_misses);
+  EXPECT_EQ(1u, counters.cache_misses_by_reason
+                    [v8::ScriptCompiler::kNoCacheBecauseCacheTooCold]);
+  EXPECT_EQ(1u, counters.timestamps_set);
+  EXPECT_EQ(0u, counters.caches_produced);
+  EXPECT_EQ(1u, counters.not_streamed_by_reason[static_cast<size_t>(
+                    ScriptStreamer::NotStreamingReason::kScriptTooSmall)]);
+
+  // Warm run - should produce code cache.
+  EXPECT_TRUE(CompileScript(scope.GetIsolate(), scope.GetScriptState(),
+                            *classic_script,
+                            mojom::blink::V8CacheOptions::kDefault));
+  counters = statistics.ForScript(url);
+  EXPECT_EQ(2u, counters.cache_misses);
+  EXPECT_EQ(1u,
+            counters.cache_misses_by_reason
+                [v8::ScriptCompiler::kNoCacheBecauseDeferredProduceCodeCache]);
+  EXPECT_EQ(1u, counters.caches_produced);
+  EXPECT_EQ(0u, counters.full_caches_produced);
+  EXPECT_GT(counters.bytes_produced, 0u);
+
+  // Hot run - should consume code cache.
+  EXPECT_TRUE(CompileScript(scope.GetIsolate(), scope.GetScriptState(),
+                            *classic_script,
+                            mojom::blink::V8CacheOptions::kDefault));
+  counters = statistics.ForScript(url);
+  EXPECT_EQ(3u, counters.compiles);
+  EXPECT_EQ(1u, counters.cache_hits);
+  EXPECT_EQ(0u, counters.cache_rejects);
+  EXPECT_EQ(counters.bytes_produced, counters.bytes_consumed);
+
+  // The origin and the total include the script.
+  EXPECT_EQ(3u, statistics.ForOrigin(url).compiles);
+  EXPECT_EQ(3u, statistics.Total().compiles);
+  EXPECT_EQ(1u, statistics.Total().cache_hits);
+}
+
+TEST_F(V8ScriptRunnerTest, codeCacheStatisticsDisabled) {
+  V8TestingScope scope;
+  ClassicScript* classic_script = CreateScript(CreateResource(UTF8Encoding()));
+  EXPECT_FALSE(V8CodeCacheStatistics::IsEnabled());
+
+  // Cold and warm runs - should record nothing.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(CompileScript(scope.GetIsolate(), scope.GetScriptState(),
+                              *classic_script,
+                              mojom::blink::V8CacheOptions::kDefault));
+  }
+  EXPECT_EQ(0u, V8CodeCacheStatistics::Get().Total().compiles);
+  EXPECT_EQ(0u, V8CodeCacheStatistics::Get().Total().timestamps_set);
+  EXPECT_EQ(0u, V8CodeCacheStatistics::Get().Total().caches_produced);
+}
+
+TEST_F(V8ScriptRunnerTest, eagerProduceAtFirstExecution) {
+  feature_list_.InitWithFeaturesAndParameters(
+      {{features::kV8CodeCacheEagerProduce, {{"executions", "1"}}},
+       {features::kV8CodeCacheStatistics, {}}},
+      {});
+  V8TestingScope scope;
+  ClassicScript* classic_script = CreateScript(CreateResource(UTF8Encoding()));
+  SingleCachedMetadataHandler* cache_handler = classic_script->CacheHandler();
+
+  v8::ScriptCompiler::CompileOptions compile_options;
+  V8CodeCache::ProduceCacheOptions produce_cache_options;
+  v8::ScriptCompiler::NoCacheReason no_cache_reason;
+  std::tie(compile_options, produce_cache_options, no_cache_reason) =
+      V8CodeCache::GetCompileOptions(mojom::blink::V8CacheOptions::kDefault,
+                                     *classic_script);
+  EXPECT_EQ(compile_options, v8::ScriptCompiler::kEagerCompile);
+  EXPECT_EQ(produce_cache_options,
+            V8CodeCache::ProduceCacheOptions::kProduceCodeCache);
+
+  // Cold run - should produce full code cache without the timestamp.
+  EXPECT_TRUE(CompileScript(scope.GetIsolate(), scope.GetScriptState(),
+                            *classic_script, compile_options, no_cache_reason,
+                            produce_cache_options));
+  EXPECT_TRUE(cache_handler->GetCachedMetadata(TagForCodeCache(cache_handler)));
+  V8CodeCacheStatistics::Counters counters =
+      V8CodeCacheStatistics::Get().ForScript(classic_script->SourceUrl());
+  EXPECT_EQ(0u, counters.timestamps_set);
+  EXPECT_EQ(1u, counters.full_caches_produced);
+
+  // Hot run - should consume code cache.
+  std::tie(compile_options, produce_cache_options, no_cache_reason) =
+      V8CodeCache::GetCompileOptions(mojom::blink::V8CacheOptions::kDefault,
+                                     *classic_script);
+  EXPECT_EQ(compile_options, v8::ScriptCompiler::kConsumeCodeCache);
+  EXPECT_EQ(produce_cache_options,
+            V8CodeCache::ProduceCacheOptions::kNoProduceCache);
+}
+
+TEST_F(V8ScriptRunnerTest, eagerProduceAtSecondExecution) {
+  feature_list_.InitWithFeatures({features::kV8CodeCacheEagerProduce,
+                                  features::kV8CodeCacheStatistics},
+                                 {});
+  V8TestingScope scope;
+  ClassicScript* classic_script = CreateScript(CreateResource(UTF8Encoding()));
+  SingleCachedMetadataHandler* cache_handler = classic_script->CacheHandler();
+
+  // Cold run - should set the timestamp as usual.
+  v8::ScriptCompiler::CompileOptions compile_options;
+  V8CodeCache::ProduceCacheOptions produce_cache_options;
+  v8::ScriptCompiler::NoCacheReason no_cache_reason;
+  std::tie(compile_options, produce_cache_options, no_cache_reason) =
+      V8CodeCache::GetCompileOptions(mojom::blink::V8CacheOptions::kDefault,
+                                     *classic_script);
+  EXPECT_EQ(compile_options, v8::ScriptCompiler::kNoCompileOptions);
+  EXPECT_EQ(produce_cache_options,
+            V8CodeCache::ProduceCacheOptions::kSetTimeStamp);
+  EXPECT_TRUE(CompileScript(scope.GetIsolate(), scope.GetScriptState(),
+                            *classic_script, compile_options, no_cache_reason,
+                            produce_cache_options));
+
+  // Warm run - should compile eagerly and produce full code cache.
+  std::tie(compile_options, produce_cache_options, no_cache_reason) =
+      V8CodeCache::GetCompileOptions(mojom::blink::V8CacheOptions::kDefault,
+                                     *classic_script);
+  EXPECT_EQ(compile_options, v8::ScriptCompiler::kEagerCompile);
+  EXPECT_EQ(produce_cache_options,
+            V8CodeCache::ProduceCacheOptions::kProduceCodeCache);
+  EXPECT_TRUE(CompileScript(scope.GetIsolate(), scope.GetScriptState(),
+                            *classic_script, compile_options, no_cache_reason,
+                            produce_cache_options));
+  EXPECT_TRUE(cache_handler->GetCachedMetadata(TagForCodeCache(cache_handler)));
+  EXPECT_EQ(1u, V8CodeCacheStatistics::Get()
+                    .ForScript(classic_script->SourceUrl())
+                    .full_caches_produced);
+}
+
+TEST_F(V8ScriptRunnerTest, eagerProduceAtThirdExecution) {
+  feature_list_.InitAndEnableFeatureWithParameters(
+      features::kV8CodeCacheEagerProduce, {{"executions", "3"}});
+  V8TestingScope scope;
+  ClassicScript* classic_script = CreateScript(CreateResource(UTF8Encoding()));
+  SingleCachedMetadataHandler* cache_handler = classic_script->CacheHandler();
+
+  // Cold and warm runs - should only count the executions in the timestamp,
+  // without producing the code cache from the lazily compiled script.
+  v8::ScriptCompiler::CompileOptions compile_options;
+  V8CodeCache::ProduceCacheOptions produce_cache_options;
+  v8::ScriptCompiler::NoCacheReason no_cache_reason;
+  for (int i = 0; i < 2; ++i) {
+    std::tie(compile_options, produce_cache_options, no_cache_reason) =
+        V8CodeCache::GetCompileOptions(mojom::blink::V8CacheOptions::kDefault,
+                                       *classic_script);
+    EXPECT_EQ(compile_options, v8::ScriptCompiler::kNoCompileOptions);
+    EXPECT_EQ(produce_cache_options,
+              V8CodeCache::ProduceCacheOptions::kSetTimeStamp);
+    EXPECT_TRUE(CompileScript(scope.GetIsolate(), scope.GetScriptState(),
+                              *classic_script, compile_options,
+                              no_cache_reason, produce_cache_options));
+    EXPECT_TRUE(
+        cache_handler->GetCachedMetadata(TagForTimeStamp(cache_handler)));
+    EXPECT_FALSE(
+        cache_handler->GetCachedMetadata(TagForCodeCache(cache_handler)));
+  }
+
+  // Third run - should compile eagerly and produce full code cache.
+  std::tie(compile_options, produce_cache_options, no_cache_reason) =
+      V8CodeCache::GetCompileOptions(mojom::blink::V8CacheOptions::kDefault,
+                                     *classic_script);
+  EXPECT_EQ(compile_options, v8::ScriptCompiler::kEagerCompile);
+  EXPECT_EQ(produce_cache_options,
+            V8CodeCache::ProduceCacheOptions::kProduceCodeCache);
+  EXPECT_TRUE(CompileScript(scope.GetIsolate(), scope.GetScriptState(),
+                            *classic_script, compile_options, no_cache_reason,
+                            produce_cache_options));
+  EXPECT_TRUE(cache_handler->GetCachedMetadata(TagForCodeCache(cache_handler)));
+}
+
+TEST_F(V8ScriptRunnerTest, eagerProduceWithTimeStampFromEarlierProcess) {
+  feature_list_.InitWithFeatures({features::kV8CodeCacheEagerProduce,
+                                  features::kV8CodeCacheStatistics},
+                                 {});
+  V8TestingScope scope;
+  ClassicScript* classic_script = CreateScript(CreateResource(UTF8Encoding()));
+  SingleCachedMetadataHandler* cache_handler = classic_script->CacheHandler();
+
+  // The timestamp was stored by an earlier run which this process has no
+  // statistics for, e.g. before a renderer restart. The policy goes by the
+  // cache handler only.
+  SetCacheTimeStamp(ExecutionContext::GetCodeCacheHostFromContext(
+                        scope.GetExecutionContext()),
+                    cache_handler);
+  EXPECT_EQ(0u, V8CodeCacheStatistics::Get()
+                    .ForScript(classic_script->SourceUrl())
+                    .compiles);
+
+  v8::ScriptCompiler::CompileOptions compile_options;
+  V8CodeCache::ProduceCacheOptions produce_cache_options;
+  v8::ScriptCompiler::NoCacheReason no_cache_reason;
+  std::tie(compile_options, produce_cache_options, no_cache_reason) =
+      V8CodeCache::GetCompileOptions(mojom::blink::V8CacheOptions::kDefault,
+                                     *classic_script);
+  EXPECT_EQ(compile_options, v8::ScriptCompiler::kEagerCompile);
+  EXPECT_EQ(produce_cache_options,
+            V8CodeCache::ProduceCacheOptions::kProduceCodeCache);
+}
+
 namespace {
 
 class StubScriptCacheConsumerClient final
@@ -37,6 +37,7 @@ from .callback_function import generate_callback_functions
 from .callback_interface import generate_callback_interfaces
 from .dictionary import generate_dictionaries
 from .enumeration import generate_enumerations
+from .generation_cache import GenerationCache
 from .interface import generate_interfaces
 from .namespace import generate_namespaces
 from .observable_array import generate_observable_arrays
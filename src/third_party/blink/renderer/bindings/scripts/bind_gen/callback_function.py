@@ -668,5 +668,5 @@ def generate_callback_functions(task_queue):
             # OnErrorEventHandlerNonNull and OnBeforeUnloadEventHandlerNonNull
             # are unified into EventHandlerNonNull, and they won't be used.
             continue
-        task_queue.post_task(generate_callback_function,
-                             callback_function.identifier)
+        task_queue.post_definition_task(generate_callback_function,
+                                        callback_function.identifier)
@@ -377,5 +377,5 @@ def generate_callback_interfaces(task_queue):
     web_idl_database = package_initializer().web_idl_database()
 
     for callback_interface in web_idl_database.callback_interfaces:
-        task_queue.post_task(generate_callback_interface,
-                             callback_interface.identifier)
+        task_queue.post_definition_task(generate_callback_interface,
+                                        callback_interface.identifier)
@@ -15,6 +15,7 @@ from .code_node import SequenceNode
 from .code_node import render_code_node
 from .codegen_accumulator import CodeGenAccumulator
 from .path_manager import PathManager
+from .task_queue import record_output_filepath
 
 
 def make_copyright_header():
@@ -203,3 +204,4 @@ def write_code_node_to_file(code_node, filepath):
 
     web_idl.file_io.write_to_file_if_changed(
         filepath, format_result.contents.encode('utf-8'))
+    record_output_filepath(filepath)
@@ -1118,4 +1118,5 @@ def generate_dictionaries(task_queue):
     web_idl_database = package_initializer().web_idl_database()
 
     for dictionary in web_idl_database.dictionaries:
-        task_queue.post_task(generate_dictionary, dictionary.identifier)
+        task_queue.post_definition_task(generate_dictionary,
+                                        dictionary.identifier)
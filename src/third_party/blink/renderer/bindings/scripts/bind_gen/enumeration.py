@@ -59,7 +59,7 @@ def make_factory_methods(cg_context):
 
     func_def.body.extend([
         T("const auto& result = bindings::FindIndexInEnumStringTable("
-          "isolate, value, string_table_, \"${enumeration.identifier}\", "
+          "isolate, value, kLookupTable, \"${enumeration.identifier}\", "
           "exception_state);"),
         T("return result.has_value() ? "
           "${class_name}(static_cast<Enum>(result.value())) : "
@@ -81,7 +81,7 @@ def make_factory_methods(cg_context):
 
     func_def.body.extend([
         T("const auto& result = bindings::FindIndexInEnumStringTable"
-          "(value, string_table_);"),
+          "(value, kLookupTable);"),
         T("if (!result)\n"
           "  return absl::nullopt;"),
         T("return ${class_name}(static_cast<Enum>(result.value()));"),
@@ -180,7 +180,7 @@ def make_assignment_operators(cg_context):
     func_def.body.append(
         TextNode("""\
 const auto& index =
-    bindings::FindIndexInEnumStringTable(str_value, string_table_);
+    bindings::FindIndexInEnumStringTable(str_value, kLookupTable);
 CHECK(index.has_value());
 return operator=(${class_name}(static_cast<Enum>(index.value())));
 """))
@@ -262,6 +262,53 @@ def make_enum_string_table(cg_context):
     return decls, defs
 
 
+def make_enum_lookup_table(cg_context):
+    assert isinstance(cg_context, CodeGenContext)
+
+    T = TextNode
+
+    # The entries are sorted by length and then by value, and the offsets
+    # point to the first entry of each length.  See
+    # bindings::EnumStringLookupTable for how they are used.
+    values = cg_context.enumeration.values
+    # The lookup compares the characters of a string with the bytes of the
+    # entries one by one, and buckets them by the number of characters, which
+    # only agree with each other for ASCII values.
+    for value in values:
+        assert all(ord(c) < 0x80 for c in value), (
+            "Non-ASCII enum value '{}' of {}".format(
+                value, cg_context.enumeration.identifier))
+    sorted_values = sorted(values, key=lambda value: (len(value), value))
+    max_length = len(sorted_values[-1])
+    length_offsets = []
+    offset = 0
+    for length in range(max_length + 2):
+        while (offset < len(sorted_values)
+               and len(sorted_values[offset]) < length):
+            offset += 1
+        length_offsets.append(offset)
+
+    entries = [
+        T("{{\"{}\", {}}}".format(value, values.index(value)))
+        for value in sorted_values
+    ]
+    offsets = [T(str(offset)) for offset in length_offsets]
+
+    return ListNode([
+        T("constexpr bindings::EnumStringLookupTable::Entry "
+          "kLookupEntries[] = {"),
+        ListNode(entries, separator=", "),
+        T("};"),
+        EmptyNode(),
+        T("constexpr uint16_t kLookupLengthOffsets[] = {"),
+        ListNode(offsets, separator=", "),
+        T("};"),
+        EmptyNode(),
+        T("constexpr bindings::EnumStringLookupTable kLookupTable = {"
+          "kLookupEntries, kLookupLengthOffsets};"),
+    ])
+
+
 def generate_enumeration(enumeration_identifier):
     assert isinstance(enumeration_identifier, web_idl.Identifier)
 
@@ -314,6 +361,7 @@ def generate_enumeration(enumeration_identifier):
     equal_decls, equal_defs = make_equality_operators(cg_context)
     nested_enum_class_def = make_nested_enum_class_def(cg_context)
     table_decls, table_defs = make_enum_string_table(cg_context)
+    lookup_table_defs = make_enum_lookup_table(cg_context)
     as_enum_decl, as_enum_def = make_as_enum_function(cg_context)
 
     # Header part (copyright, include directives, and forward declarations)
@@ -366,6 +414,9 @@ def generate_enumeration(enumeration_identifier):
 
     class_def.private_section.append(table_decls)
     class_def.private_section.append(EmptyNode())
+    source_blink_ns.body.append(
+        CxxNamespaceNode(name="", body=lookup_table_defs))
+    source_blink_ns.body.append(EmptyNode())
     source_blink_ns.body.append(table_defs)
     source_blink_ns.body.append(EmptyNode())
 
@@ -410,4 +461,5 @@ def generate_enumerations(task_queue):
     web_idl_database = package_initializer().web_idl_database()
 
     for enumeration in web_idl_database.enumerations:
-        task_queue.post_task(generate_enumeration, enumeration.identifier)
+        task_queue.post_definition_task(generate_enumeration,
+                                        enumeration.identifier)
@@ -0,0 +1,109 @@
+# Copyright 2022 The Chromium Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+import glob
+import hashlib
+import json
+import os.path
+
+import web_idl
+
+
+class GenerationCache(object):
+    """
+    Remembers what each task of code generation generated from what contents,
+    so that a later run can skip the tasks whose inputs have not changed since
+    the last run.
+
+    The cache is saved as a JSON file in the form of:
+
+        { "version": format version,
+          "generator": fingerprint of the code generator and its settings,
+          "tasks": { task_key: { "fingerprint": fingerprint of the inputs,
+                                 "outputs": [ generated filepath, ... ] },
+                     ... },
+        }
+
+    The whole cache is discarded when the code generator or its settings
+    change.
+    """
+
+    _FORMAT_VERSION = 1
+
+    def __init__(self, filepath, settings):
+        """
+        Args:
+            filepath: File path to the cache, which may not exist yet.
+            settings: A list of the settings of the code generator that may
+                affect the generated code.
+        """
+        assert isinstance(filepath, str)
+        assert isinstance(settings, (list, tuple))
+        assert all(isinstance(setting, str) for setting in settings)
+
+        self._filepath = filepath
+        self._generator_fingerprint = _compute_generator_fingerprint(settings)
+        self._entries = {}
+
+        try:
+            with open(filepath, 'r') as file_obj:
+                contents = json.load(file_obj)
+        except (OSError, EnvironmentError, ValueError):
+            return
+        if (contents.get('version') == GenerationCache._FORMAT_VERSION
+                and contents.get('generator') == self._generator_fingerprint):
+            self._entries = contents.get('tasks', {})
+
+    def is_up_to_date(self, task_key, fingerprint):
+        """
+        Returns True if the task ran with the inputs of |fingerprint| last time
+        and all the files that it generated still exist.
+        """
+        entry = self._entries.get(task_key)
+        return bool(entry and entry['fingerprint'] == fingerprint
+                    and all(map(os.path.exists, entry['outputs'])))
+
+    def update(self, task_key, fingerprint, output_filepaths):
+        """Records that the task generated |output_filepaths|."""
+        self._entries[task_key] = {
+            'fingerprint': fingerprint,
+            'outputs': sorted(set(output_filepaths)),
+        }
+
+    def save(self, task_keys):
+        """
+        Writes the cache out to the file.  The entries of the tasks that are
+        not in |task_keys| are dropped.
+        """
+        task_keys = set(task_keys)
+        contents = {
+            'version': GenerationCache._FORMAT_VERSION,
+            'generator': self._generator_fingerprint,
+            'tasks': dict((key, value) for key, value in self._entries.items()
+                          if key in task_keys),
+        }
+        web_idl.file_io.write_to_file_if_changed(
+            self._filepath,
+            json.dumps(contents, indent=1, sort_keys=True).encode('utf-8'))
+
+
+def _compute_generator_fingerprint(settings):
+    # The generated code depends on the code generator itself, i.e. the sources
+    # of bind_gen and web_idl packages.
+    scripts_dir = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    filepaths = []
+    for package in ('bind_gen', 'web_idl'):
+        filepaths.extend(glob.glob(os.path.join(scripts_dir, package, '*.py')))
+
+    hasher = hashlib.sha256()
+    for setting in settings:
+        hasher.update(setting.encode('utf-8'))
+        hasher.update(b'\0')
+    for filepath in sorted(filepaths):
+        hasher.update(os.path.basename(filepath).encode('utf-8'))
+        hasher.update(b'\0')
+        with open(filepath, 'rb') as file_obj:
+            hasher.update(file_obj.read())
+        hasher.update(b'\0')
+    return hasher.hexdigest()
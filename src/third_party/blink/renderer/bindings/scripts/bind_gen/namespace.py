@@ -27,4 +27,5 @@ def generate_namespaces(task_queue):
     web_idl_database = package_initializer().web_idl_database()
 
     for namespace in web_idl_database.namespaces:
-        task_queue.post_task(generate_namespace, namespace.identifier)
+        task_queue.post_definition_task(generate_namespace,
+                                        namespace.identifier)
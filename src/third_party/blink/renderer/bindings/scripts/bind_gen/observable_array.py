@@ -546,5 +546,5 @@ def generate_observable_arrays(task_queue):
     web_idl_database = package_initializer().web_idl_database()
 
     for observable_array in web_idl_database.observable_arrays:
-        task_queue.post_task(generate_observable_array,
-                             observable_array.identifier)
+        task_queue.post_definition_task(generate_observable_array,
+                                        observable_array.identifier)
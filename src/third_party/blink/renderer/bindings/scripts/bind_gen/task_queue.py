@@ -6,8 +6,26 @@ import functools
 import multiprocessing
 import sys
 
+import web_idl
+
+from .generation_cache import GenerationCache
 from .package_initializer import package_initializer
 
+# File paths that the running task has written to.
+_output_filepaths = []
+
+
+def record_output_filepath(filepath):
+    """Records that the running task writes to |filepath|."""
+    _output_filepaths.append(filepath)
+
+
+def _run_task(func, args, kwargs):
+    """Runs the task and returns the file paths that it has written to."""
+    del _output_filepaths[:]
+    func(*args, **kwargs)
+    return list(_output_filepaths)
+
 
 class TaskQueue(object):
     """
@@ -15,28 +33,23 @@ class TaskQueue(object):
     tasks will be executed in parallel.
     """
 
-    def __init__(self, single_process=False):
+    def __init__(self, single_process=False, generation_cache=None):
         """
         Args:
             single_process: True makes the instance will not create nor use a
                 child process so that error messages will be easier to read.
                 This is useful for debugging.
+            generation_cache: A GenerationCache or None.  If specified, tasks
+                whose inputs have not changed since the last run are skipped.
         """
         assert isinstance(single_process, bool)
-        if single_process:
-            self._single_process = True
-            self._pool_size = 1
-            self._pool = None
-        else:
-            self._single_process = False
-            self._pool_size = multiprocessing.cpu_count()
-            if sys.platform == 'win32':
-                # TODO(crbug.com/1190269) - we can't use more than 56
-                # cores on Windows or Python3 may hang.
-                self._pool_size = min(self._pool_size, 56)
-            self._pool = multiprocessing.Pool(self._pool_size,
-                                              package_initializer().init)
+        assert (generation_cache is None
+                or isinstance(generation_cache, GenerationCache))
+        self._single_process = single_process
+        self._generation_cache = generation_cache
         self._requested_tasks = []  # List of (func, args, kwargs)
+        # List of the keys and fingerprints of |_requested_tasks|
+        self._task_fingerprints = []
         self._worker_tasks = []  # List of multiprocessing.pool.AsyncResult
         self._did_run = False
 
@@ -44,9 +57,33 @@ class TaskQueue(object):
         """
         Schedules a new task to be executed when |run| method is invoked.  This
         method does not kick any execution, only puts a new task in the queue.
+
+        The task is regarded as depending on all the IDL definitions.
         """
         assert not self._did_run
+        web_idl_database = package_initializer().web_idl_database()
+        self._post_task(web_idl_database.fingerprint, func, args, kwargs)
+
+    def post_definition_task(self, func, identifier, *args, **kwargs):
+        """
+        Schedules a new task in the same way as |post_task|, where the task
+        generates code for the IDL definition of |identifier|, which is passed
+        to |func| as the first argument.
+
+        The task is regarded as depending only on the IDL definition and what
+        web_idl.Database.fingerprint_of covers.
+        """
+        assert not self._did_run
+        assert isinstance(identifier, web_idl.Identifier)
+        web_idl_database = package_initializer().web_idl_database()
+        self._post_task(web_idl_database.fingerprint_of(identifier), func,
+                        (identifier, ) + args, kwargs)
+
+    def _post_task(self, inputs_fingerprint, func, args, kwargs):
+        task_key = '{}.{}{!r}{!r}'.format(func.__module__, func.__name__, args,
+                                          sorted(kwargs.items()))
         self._requested_tasks.append((func, args, kwargs))
+        self._task_fingerprints.append((task_key, inputs_fingerprint))
 
     def run(self, report_progress=None):
         """
@@ -61,24 +98,49 @@ class TaskQueue(object):
         assert not self._worker_tasks
         self._did_run = True
 
-        if self._single_process:
-            self._run_in_sequence(report_progress)
+        tasks = []  # List of (func, args, kwargs, task_key, fingerprint)
+        for task, key_and_fingerprint in zip(self._requested_tasks,
+                                             self._task_fingerprints):
+            if (self._generation_cache and self._generation_cache.is_up_to_date(
+                    *key_and_fingerprint)):
+                continue
+            tasks.append(task + key_and_fingerprint)
+
+        # Do not spin up worker processes, each of which loads the whole
+        # web_idl.Database, when there is little to do.
+        pool_size = min(multiprocessing.cpu_count(), len(tasks))
+        if sys.platform == 'win32':
+            # TODO(crbug.com/1190269) - we can't use more than 56
+            # cores on Windows or Python3 may hang.
+            pool_size = min(pool_size, 56)
+        if self._single_process or pool_size <= 1:
+            self._run_in_sequence(tasks, report_progress)
         else:
-            self._run_in_parallel(report_progress)
-
-    def _run_in_sequence(self, report_progress):
-        for index, task in enumerate(self._requested_tasks):
-            func, args, kwargs = task
-            report_progress(len(self._requested_tasks), index)
-            func(*args, **kwargs)
-        report_progress(len(self._requested_tasks), len(self._requested_tasks))
-
-    def _run_in_parallel(self, report_progress):
-        for task in self._requested_tasks:
-            func, args, kwargs = task
+            self._run_in_parallel(tasks, pool_size, report_progress)
+
+        if self._generation_cache:
+            self._generation_cache.save(
+                [task_key for task_key, _ in self._task_fingerprints])
+
+    def _run_in_sequence(self, tasks, report_progress):
+        for index, task in enumerate(tasks):
+            func, args, kwargs, task_key, fingerprint = task
+            if report_progress:
+                report_progress(len(tasks), index)
+            output_filepaths = _run_task(func, args, kwargs)
+            if self._generation_cache:
+                self._generation_cache.update(task_key, fingerprint,
+                                              output_filepaths)
+        if report_progress:
+            report_progress(len(tasks), len(tasks))
+
+    def _run_in_parallel(self, tasks, pool_size, report_progress):
+        pool = multiprocessing.Pool(pool_size, package_initializer().init)
+        for task in tasks:
+            func, args, kwargs, _, _ = task
             self._worker_tasks.append(
-                self._pool.apply_async(func, args, kwargs))
-        self._pool.close()
+                pool.apply_async(_run_task, (func, args, kwargs)))
+        pool.close()
 
         def report_worker_task_progress():
             if not report_progress:
@@ -101,4 +163,10 @@ class TaskQueue(object):
             else:
                 break
 
-        self._pool.join()
+        pool.join()
+
+        if self._generation_cache:
+            for task, worker_task in zip(tasks, self._worker_tasks):
+                _, _, _, task_key, fingerprint = task
+                self._generation_cache.update(task_key, fingerprint,
+                                              worker_task.get())
@@ -1108,4 +1108,4 @@ def generate_unions(task_queue):
     web_idl_database = package_initializer().web_idl_database()
 
     for union in web_idl_database.union_types:
-        task_queue.post_task(generate_union, union.identifier)
+        task_queue.post_definition_task(generate_union, union.identifier)
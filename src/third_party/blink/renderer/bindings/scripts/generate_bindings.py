@@ -63,6 +63,11 @@ def parse_options(valid_tasks):
         default=False,
         help=('run everything in a single process, which makes debugging '
               'easier'))
+    parser.add_argument(
+        '--generation_cache',
+        type=str,
+        help=('filepath of the cache of the previous run.  If specified, the '
+              'tasks whose inputs have not changed since then are skipped.'))
     parser.add_argument('tasks',
                         nargs='+',
                         choices=valid_tasks,
@@ -100,7 +105,17 @@ def main():
                   component_reldirs=component_reldirs,
                   enable_style_format=options.format_generated_files)
 
-    task_queue = bind_gen.TaskQueue(single_process=options.single_process)
+    generation_cache = None
+    if options.generation_cache:
+        generation_cache = bind_gen.GenerationCache(
+            options.generation_cache,
+            settings=[
+                options.root_src_dir, options.root_gen_dir,
+                str(options.format_generated_files)
+            ] + sorted(options.output_reldir))
+
+    task_queue = bind_gen.TaskQueue(single_process=options.single_process,
+                                    generation_cache=generation_cache)
 
     for task in options.tasks:
         dispatch_table[task](task_queue)
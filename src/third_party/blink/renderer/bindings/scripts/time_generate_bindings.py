@@ -0,0 +1,231 @@
+# Copyright 2022 The Chromium Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+"""
+Measures how long the bindings code generation takes from scratch (a cold run)
+and after a one-line edit of an IDL file (an incremental run), using the
+generation cache of generate_bindings.py.
+
+The IDL files in the "core" and "modules" subdirectories of the given directory,
+by default the ones of this checkout, are copied into a temporary directory, so
+the given directory is never modified.  Usage:
+
+  time_generate_bindings.py [--idl_dir=DIR] [--edit_file=RELPATH] [TASK...]
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+_SCRIPTS_DIR = os.path.dirname(os.path.abspath(__file__))
+_BINDINGS_DIR = os.path.dirname(_SCRIPTS_DIR)
+_SRC_DIR = os.path.abspath(os.path.join(_BINDINGS_DIR, *(['..'] * 4)))
+_RENDERER_DIR = os.path.dirname(_BINDINGS_DIR)
+
+_COMPONENTS = ['core', 'modules']
+
+_ALL_TASKS = [
+    'callback_function',
+    'callback_interface',
+    'dictionary',
+    'enumeration',
+    'interface',
+    'namespace',
+    'observable_array',
+    'typedef',
+    'union',
+]
+
+# Matches the first line of the body of a dictionary or an interface.
+_DEFINITION_BODY_PATTERN = re.compile(
+    r'^\s*(?:partial\s+)?(dictionary|interface)\s+\w+[^{;]*\{[ \t]*\n',
+    re.MULTILINE)
+_INSERTED_MEMBERS = {
+    'dictionary': '  long timeGenerateBindingsMember;\n',
+    'interface': '  attribute long timeGenerateBindingsAttribute;\n',
+}
+
+
+def parse_options():
+    parser = argparse.ArgumentParser(description=__doc__.strip().split('\n')[0])
+    parser.add_argument(
+        '--idl_dir',
+        default=_RENDERER_DIR,
+        help=('directory that has the IDL files of core and modules '
+              'components in its "core" and "modules" subdirectories '
+              '(default: %(default)s)'))
+    parser.add_argument(
+        '--edit_file',
+        default=os.path.join('core', 'dom', 'abort_controller.idl'),
+        help=('IDL file to be edited, relative to --idl_dir.  A member is '
+              'added to its first dictionary or interface (default: '
+              '%(default)s)'))
+    parser.add_argument(
+        '--runtime_enabled_features',
+        default=os.path.join(_BINDINGS_DIR, '..', 'platform',
+                             'runtime_enabled_features.json5'),
+        help='filepath to runtime_enabled_features.json5')
+    parser.add_argument('--single_process',
+                        action='store_true',
+                        default=False,
+                        help='pass --single_process to generate_bindings.py')
+    parser.add_argument('tasks',
+                        nargs='*',
+                        help='types to generate (default: all)')
+    options = parser.parse_args()
+
+    for task in options.tasks:
+        if task not in _ALL_TASKS:
+            parser.error('invalid task "{}"'.format(task))
+    if not options.tasks:
+        options.tasks = _ALL_TASKS
+
+    return options
+
+
+def run_script(script, args):
+    subprocess.check_call([sys.executable,
+                           os.path.join(_SCRIPTS_DIR, script)] + args)
+
+
+def copy_idl_files(src_dir, dst_dir):
+    """
+    Copies the IDL files of the components in |src_dir| into |dst_dir|, and
+    returns the copied file paths per (component, for_testing).  Like the
+    build, the IDL files in "testing" directories are for testing.
+    """
+    filepaths_per_group = {}
+    for component in _COMPONENTS:
+        component_dir = os.path.join(src_dir, component)
+        for dirpath, _, filenames in os.walk(component_dir):
+            relpath = os.path.relpath(dirpath, src_dir)
+            for_testing = 'testing' in relpath.split(os.sep)
+            filepaths = filepaths_per_group.setdefault(
+                (component, for_testing), [])
+            for filename in filenames:
+                if not filename.endswith('.idl'):
+                    continue
+                dst_path = os.path.join(dst_dir, relpath, filename)
+                if not os.path.isdir(os.path.dirname(dst_path)):
+                    os.makedirs(os.path.dirname(dst_path))
+                shutil.copy2(os.path.join(dirpath, filename), dst_path)
+                filepaths.append(dst_path)
+    return filepaths_per_group
+
+
+def generate(options, work_dir, filepaths_per_group):
+    """Runs the whole pipeline and returns a list of (step, seconds)."""
+    timings = []
+
+    start = time.time()
+    ast_groups = []
+    for (component, for_testing), filepaths in sorted(
+            filepaths_per_group.items()):
+        if not filepaths:
+            continue
+        name = component + ('_for_testing' if for_testing else '')
+        list_file = os.path.join(work_dir, '{}.txt'.format(name))
+        with open(list_file, 'w') as file_obj:
+            file_obj.write('\n'.join(sorted(filepaths)))
+        ast_group = os.path.join(work_dir, '{}.pickle'.format(name))
+        args = ['--idl_list_file', list_file, '--component', component]
+        if for_testing:
+            args.append('--for_testing')
+        run_script('collect_idl_files.py',
+                   args + ['--output', ast_group])
+        ast_groups.append(ast_group)
+    timings.append(('collect_idl_files', time.time() - start))
+
+    start = time.time()
+    database = os.path.join(work_dir, 'web_idl_database.pickle')
+    run_script('build_web_idl_database.py', [
+        '--output', database, '--runtime_enabled_features',
+        options.runtime_enabled_features
+    ] + ast_groups)
+    timings.append(('build_web_idl_database', time.time() - start))
+
+    start = time.time()
+    args = [
+        '--web_idl_database', database, '--root_src_dir', _SRC_DIR,
+        '--root_gen_dir',
+        os.path.join(work_dir, 'gen'), '--output_reldir',
+        'core=third_party/blink/renderer/bindings/core/v8/',
+        '--output_reldir',
+        'modules=third_party/blink/renderer/bindings/modules/v8/',
+        '--generation_cache',
+        os.path.join(work_dir, 'generation_cache.json')
+    ]
+    if options.single_process:
+        args.append('--single_process')
+    run_script('generate_bindings.py', args + options.tasks)
+    timings.append(('generate_bindings', time.time() - start))
+
+    return timings
+
+
+def count_generated_files(gen_dir, since):
+    total = 0
+    written = 0
+    for dirpath, _, filenames in os.walk(gen_dir):
+        for filename in filenames:
+            total += 1
+            if os.path.getmtime(os.path.join(dirpath, filename)) >= since:
+                written += 1
+    return written, total
+
+
+def edit_idl_file(filepath):
+    with open(filepath) as file_obj:
+        contents = file_obj.read()
+    match = _DEFINITION_BODY_PATTERN.search(contents)
+    if not match:
+        sys.exit('No dictionary or interface found in {}'.format(filepath))
+    contents = (contents[:match.end()] + _INSERTED_MEMBERS[match.group(1)] +
+                contents[match.end():])
+    with open(filepath, 'w') as file_obj:
+        file_obj.write(contents)
+
+
+def report(name, timings, gen_dir, since):
+    written, total = count_generated_files(gen_dir, since)
+    print('{}:'.format(name))
+    for step, seconds in timings:
+        print('  {:<24}{:8.2f} s'.format(step, seconds))
+    print('  {:<24}{:8.2f} s'.format('total',
+                                     sum(seconds for _, seconds in timings)))
+    print('  {:<24}{:>8}'.format('files written',
+                                 '{}/{}'.format(written, total)))
+
+
+def main():
+    options = parse_options()
+
+    work_dir = tempfile.mkdtemp(prefix='time_generate_bindings_')
+    try:
+        idl_dir = os.path.join(work_dir, 'idls')
+        filepaths_per_group = copy_idl_files(options.idl_dir, idl_dir)
+        gen_dir = os.path.join(work_dir, 'gen')
+
+        since = time.time()
+        timings = generate(options, work_dir, filepaths_per_group)
+        report('Cold run', timings, gen_dir, since)
+
+        # Make sure that the files written by the next run have newer mtimes.
+        time.sleep(1)
+
+        edit_idl_file(os.path.join(idl_dir, options.edit_file))
+        since = time.time()
+        timings = generate(options, work_dir, filepaths_per_group)
+        report('Incremental run after editing {}'.format(options.edit_file),
+               timings, gen_dir, since)
+    finally:
+        shutil.rmtree(work_dir)
+
+
+if __name__ == '__main__':
+    main()
@@ -3,6 +3,11 @@
 # found in the LICENSE file.
 
 from . import file_io
+from .composition_parts import Location
+from .dictionary import Dictionary
+from .fingerprint import combine_fingerprints
+from .fingerprint import compute_fingerprint
+from .interface import Interface
 from .observable_array import ObservableArray
 from .typedef import Typedef
 from .union import Union
@@ -23,6 +28,16 @@ class DatabaseBody(object):
           kind2 : { ... },
           ...
         }
+
+    |self._fingerprints| holds the content fingerprint of each IDL definition,
+    the identifiers of the other IDL definitions that it refers to, the
+    identifier of its inherited definition if any, and the fingerprint of what
+    code generated for it may depend on, in the form of:
+
+        { identifier_a: (content_fingerprint_a, (identifier_b, ...),
+                         inherited_identifier_a or None, fingerprint_a),
+          ...
+        }
     """
 
     class Kind(object):
@@ -58,6 +73,7 @@ class DatabaseBody(object):
         self._defs = {}
         for kind in DatabaseBody.Kind.values():
             self._defs[kind] = {}
+        self._fingerprints = {}
 
     def register(self, kind, user_defined_type):
         assert isinstance(user_defined_type,
@@ -79,6 +95,85 @@ class DatabaseBody(object):
     def find_by_kind(self, kind):
         return self._defs[kind]
 
+    def compute_fingerprints(self):
+        """
+        Computes the content fingerprints of all the IDL definitions.  This must
+        be called once all the IDL definitions are registered and finalized.
+        """
+        assert not self._fingerprints
+
+        def is_idl_definition(obj):
+            return isinstance(obj,
+                              (ObservableArray, Typedef, Union, UserDefinedType))
+
+        # The positions in IDL files are not used to generate code, unlike the
+        # line numbers, so they are excluded in order not to invalidate every
+        # definition that follows an edit in the same file.
+        ignored_attributes = [(Location, '_position')]
+
+        for defs_per_kind in self._defs.values():
+            for identifier, idl_definition in defs_per_kind.items():
+                fingerprint, references = compute_fingerprint(
+                    idl_definition,
+                    is_boundary=is_idl_definition,
+                    ignored_attributes=ignored_attributes)
+                references.discard(identifier)
+                inherited = None
+                if (isinstance(idl_definition, (Dictionary, Interface))
+                        and idl_definition.inherited):
+                    inherited = idl_definition.inherited.identifier
+                self._fingerprints[identifier] = (fingerprint,
+                                                  tuple(sorted(references)),
+                                                  inherited, None)
+
+        for identifier, entry in self._fingerprints.items():
+            fingerprint = combine_fingerprints(
+                '{}:{}'.format(x, self._fingerprints[x][0])
+                for x in sorted(self._collect_affecting_definitions(identifier)))
+            self._fingerprints[identifier] = entry[:3] + (fingerprint, )
+
+    def _collect_affecting_definitions(self, identifier):
+        # Code generated for an IDL definition looks into the contents and the
+        # inheritance chains of the IDL definitions that it refers to, e.g.
+        # with Interface.does_implement and Dictionary.has_required_member, so
+        # the inherited definitions of every collected definition are
+        # collected, too.  What is referred to is followed from the IDL
+        # definition itself, its inherited definitions, and typedefs, unions
+        # and observable arrays, which are type-like definitions whose members
+        # are looked into.  Only the identifiers are used of what the other
+        # referred definitions refer to.
+        result = set()
+        followed = set()
+        work_list = []
+
+        def add(reference, follow):
+            while reference is not None and reference in self._fingerprints:
+                result.add(reference)
+                if reference not in followed and (follow or isinstance(
+                        self.find_by_identifier(reference),
+                    (ObservableArray, Typedef, Union))):
+                    followed.add(reference)
+                    work_list.append(reference)
+                reference = self._fingerprints[reference][2]
+
+        add(identifier, True)
+        while work_list:
+            for reference in self._fingerprints[work_list.pop()][1]:
+                add(reference, False)
+        return result
+
+    def content_fingerprints(self):
+        return dict((identifier, entry[0])
+                    for identifier, entry in self._fingerprints.items())
+
+    def dependencies_of(self, identifier):
+        result = self._collect_affecting_definitions(identifier)
+        result.discard(identifier)
+        return tuple(sorted(result))
+
+    def fingerprint_of(self, identifier):
+        return self._fingerprints[identifier][3]
+
 
 class Database(object):
     """
@@ -93,6 +188,8 @@ class Database(object):
     def __init__(self, database_body):
         assert isinstance(database_body, DatabaseBody)
         self._impl = database_body
+        # Memoizes the result of |fingerprint|.
+        self._fingerprint = None
 
     @staticmethod
     def read_from_file(filepath):
@@ -110,6 +207,38 @@ class Database(object):
         """
         return self._impl.find_by_identifier(identifier)
 
+    @property
+    def fingerprint(self):
+        """Returns a fingerprint of the contents of all IDL definitions."""
+        if self._fingerprint is None:
+            self._fingerprint = combine_fingerprints(
+                '{}:{}'.format(identifier, fingerprint) for identifier,
+                fingerprint in sorted(self._impl.content_fingerprints().items()))
+        return self._fingerprint
+
+    def dependencies_of(self, identifier):
+        """
+        Returns the identifiers of the IDL definitions that code generated for
+        the IDL definition specified with |identifier| may depend on, i.e. the
+        ones that |fingerprint_of| covers other than the IDL definition itself.
+        """
+        return self._impl.dependencies_of(identifier)
+
+    def fingerprint_of(self, identifier):
+        """
+        Returns a fingerprint of the contents that code generated for the IDL
+        definition specified with |identifier| may depend on.
+
+        The fingerprint covers the contents of the IDL definition itself, of
+        the IDL definitions that it refers to, and of their inherited
+        definitions transitively.  Typedefs, unions and observable arrays are
+        type-like definitions whose members are looked into, and inherited
+        definitions are parts of the IDL definition, so what they refer to is
+        covered, too.  What the other referred definitions refer to is covered
+        only by identifier, as generated code only names it.
+        """
+        return self._impl.fingerprint_of(identifier)
+
     @property
     def callback_functions(self):
         """Returns all callback functions."""
@@ -0,0 +1,110 @@
+# Copyright 2022 The Chromium Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+import unittest
+
+from .composition_parts import Identifier
+from .database import DatabaseBody
+from .dictionary import Dictionary
+from .enumeration import Enumeration
+from .interface import Interface
+from .typedef import Typedef
+from .union import Union
+
+
+class Obj(object):
+    def __init__(self, **kwargs):
+        for name, value in kwargs.items():
+            setattr(self, name, value)
+
+
+def make(cls, identifier, inherited=None, **kwargs):
+    """
+    Makes an IDL definition of |cls| without going through the IR.  Only the
+    identifier, the inherited definition and the given attributes are set,
+    which is enough to compute the fingerprints.
+    """
+    idl_definition = cls.__new__(cls)
+    idl_definition._identifier = Identifier(identifier)
+    if cls in (Dictionary, Interface):
+        idl_definition._inherited = (Obj(target_object=inherited)
+                                     if inherited else None)
+    for name, value in kwargs.items():
+        setattr(idl_definition, name, value)
+    return idl_definition
+
+
+def build(*idl_definitions):
+    kinds = {
+        Dictionary: DatabaseBody.Kind.DICTIONARY,
+        Enumeration: DatabaseBody.Kind.ENUMERATION,
+        Interface: DatabaseBody.Kind.INTERFACE,
+        Typedef: DatabaseBody.Kind.TYPEDEF,
+        Union: DatabaseBody.Kind.UNION,
+    }
+    database_body = DatabaseBody()
+    for idl_definition in idl_definitions:
+        database_body.register(kinds[type(idl_definition)], idl_definition)
+    database_body.compute_fingerprints()
+    return database_body
+
+
+class DatabaseTest(unittest.TestCase):
+    def test_fingerprint_of_type_like_chain(self):
+        # A refers to D through a typedef of a union.
+        def build_with(value):
+            d = make(Dictionary, 'D', value=value)
+            e = make(Enumeration, 'E')
+            u = make(Union, 'U', member=Obj(idl_types=[d, e]))
+            t = make(Typedef, 'T', member=Obj(idl_type=u))
+            return build(make(Interface, 'A', member=Obj(idl_type=t)), t, u,
+                         d, e)
+
+        base = build_with(1)
+        self.assertEqual(('D', 'E', 'T', 'U'), base.dependencies_of('A'))
+        self.assertEqual(base.fingerprint_of('A'),
+                         build_with(1).fingerprint_of('A'))
+        self.assertNotEqual(base.fingerprint_of('A'),
+                            build_with(2).fingerprint_of('A'))
+
+    def test_fingerprint_of_inherited_chains(self):
+        # A inherits B, which inherits C, which refers to E.  A also refers to
+        # X, which inherits Y, which inherits Z, e.g. to check whether X
+        # implements Z.
+        def build_with(e_value, z_value):
+            e = make(Enumeration, 'E', value=e_value)
+            c = make(Interface, 'C', member=Obj(idl_type=e))
+            b = make(Interface, 'B', inherited=c)
+            z = make(Interface, 'Z', value=z_value)
+            y = make(Interface, 'Y', inherited=z)
+            x = make(Interface, 'X', inherited=y)
+            a = make(Interface, 'A', inherited=b, member=Obj(idl_type=x))
+            return build(a, b, c, e, x, y, z)
+
+        base = build_with(1, 1)
+        self.assertEqual(('B', 'C', 'E', 'X', 'Y', 'Z'),
+                         base.dependencies_of('A'))
+        self.assertNotEqual(base.fingerprint_of('A'),
+                            build_with(2, 1).fingerprint_of('A'))
+        self.assertNotEqual(base.fingerprint_of('A'),
+                            build_with(1, 2).fingerprint_of('A'))
+
+    def test_fingerprint_of_referred_member_types(self):
+        # A refers to D, whose member is of type E.  Code generated for A only
+        # names E through D, so E is covered by identifier, not by contents.
+        def build_with(e_name, e_value):
+            e = make(Enumeration, e_name, value=e_value)
+            d = make(Dictionary, 'D', member=Obj(idl_type=e))
+            return build(make(Interface, 'A', member=Obj(idl_type=d)), d, e)
+
+        base = build_with('E', 1)
+        self.assertEqual(('D', ), base.dependencies_of('A'))
+        self.assertEqual(base.fingerprint_of('A'),
+                         build_with('E', 2).fingerprint_of('A'))
+        self.assertNotEqual(base.fingerprint_of('A'),
+                            build_with('F', 1).fingerprint_of('A'))
+
+
+if __name__ == '__main__':
+    unittest.main()
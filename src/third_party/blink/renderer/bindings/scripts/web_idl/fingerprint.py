@@ -0,0 +1,147 @@
+# Copyright 2022 The Chromium Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+import hashlib
+import sys
+
+# TODO(crbug.com/1174969): Remove this once Python2 is obsoleted.
+if sys.version_info.major != 2:
+    long = int
+    basestring = str
+
+
+def compute_fingerprint(obj, is_boundary, ignored_attributes=None):
+    """
+    Computes a content fingerprint of the given object, which should be an IDL
+    definition or part of it.
+
+    The object graph is walked in a deterministic order, and every piece of
+    content reachable from |obj| contributes to the fingerprint, except that
+    objects for which |is_boundary| returns True are not walked into.  Such
+    objects (typically other IDL definitions) contribute only their type and
+    identifier, and are reported as references.
+
+    Args:
+        obj: The object to be fingerprinted.
+        is_boundary: A callable that takes an object and returns True if the
+            object must not be walked into.  |obj| itself is always walked.
+        ignored_attributes: A list of pairs of a class and an attribute name,
+            which attributes do not contribute to the fingerprint.
+    Returns:
+        A pair of the fingerprint (a hex string) and a set of the identifiers
+        of the boundary objects reachable from |obj|.
+    """
+    assert callable(is_boundary)
+    ignored_attributes = tuple(ignored_attributes or ())
+    assert all(
+        isinstance(cls, type) and isinstance(name, str)
+        for cls, name in ignored_attributes)
+
+    tokens = []
+    references = set()
+    _Walker(obj, is_boundary, ignored_attributes, tokens.append,
+            references).walk(obj)
+    hasher = hashlib.sha256()
+    for token in tokens:
+        hasher.update(token.encode('utf-8'))
+        hasher.update(b'\0')
+    return (hasher.hexdigest(), references)
+
+
+def combine_fingerprints(fingerprints):
+    """Returns a fingerprint of the given iterable of fingerprints."""
+    hasher = hashlib.sha256()
+    for fingerprint in fingerprints:
+        hasher.update(fingerprint.encode('utf-8'))
+        hasher.update(b'\0')
+    return hasher.hexdigest()
+
+
+class _Walker(object):
+    def __init__(self, root, is_boundary, ignored_attributes, emit,
+                 references):
+        self._root = root
+        self._is_boundary = is_boundary
+        self._ignored_attributes = ignored_attributes
+        self._emit = emit
+        self._references = references
+        # Objects already walked, mapped to the order of visits, so that shared
+        # objects and cycles are emitted as back references.
+        self._memo = {}
+
+    def walk(self, obj):
+        emit = self._emit
+
+        if (obj is None
+                or isinstance(obj, (bool, int, long, float, complex,
+                                    basestring))):
+            # Subclasses of str, e.g. Identifier and Component, are
+            # distinguished from plain strings.
+            emit('{}:{!r}'.format(type(obj).__name__, obj))
+            return
+
+        if obj is self._root:
+            if self._memo:
+                emit('<self>')
+                return
+        elif self._is_boundary(obj):
+            self._references.add(obj.identifier)
+            emit('<ref {}:{}>'.format(type(obj).__name__, obj.identifier))
+            return
+
+        index = self._memo.get(id(obj))
+        if index is not None:
+            emit('<backref {}>'.format(index))
+            return
+        self._memo[id(obj)] = len(self._memo)
+
+        if isinstance(obj, (list, tuple)):
+            emit('{}[{}]'.format(type(obj).__name__, len(obj)))
+            for item in obj:
+                self.walk(item)
+            return
+
+        if isinstance(obj, (set, frozenset)):
+            # The iteration order of a set may vary between processes, so each
+            # item is fingerprinted on its own and the results are sorted.
+            emit('{}[{}]'.format(type(obj).__name__, len(obj)))
+            for item_fingerprint in sorted(self._walk_apart(item)
+                                           for item in obj):
+                emit(item_fingerprint)
+            return
+
+        if isinstance(obj, dict):
+            emit('{}[{}]'.format(type(obj).__name__, len(obj)))
+            for key_fingerprint, value in sorted(
+                ((self._walk_apart(key), value) for key, value in obj.items()),
+                    key=lambda pair: pair[0]):
+                emit(key_fingerprint)
+                self.walk(value)
+            return
+
+        if hasattr(obj, '__dict__'):
+            attrs = vars(obj)
+            emit('{}.{}{{{}}}'.format(
+                type(obj).__module__,
+                type(obj).__name__, len(attrs)))
+            for name in sorted(attrs.keys()):
+                if any(
+                        isinstance(obj, cls) and name == ignored_name
+                        for cls, ignored_name in self._ignored_attributes):
+                    continue
+                emit(name)
+                self.walk(attrs[name])
+            return
+
+        assert False, 'Unsupported type of object: {}'.format(type(obj))
+
+    def _walk_apart(self, obj):
+        tokens = []
+        walker = _Walker(self._root, self._is_boundary,
+                         self._ignored_attributes, tokens.append,
+                         self._references)
+        # Objects already walked are referred to by the outer walker's order.
+        walker._memo = dict(self._memo)
+        walker.walk(obj)
+        return '\0'.join(tokens)
@@ -0,0 +1,94 @@
+# Copyright 2022 The Chromium Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+import unittest
+
+from .composition_parts import Identifier
+from .fingerprint import compute_fingerprint
+
+
+class Obj(object):
+    def __init__(self, **kwargs):
+        for name, value in kwargs.items():
+            setattr(self, name, value)
+
+
+class Definition(Obj):
+    def __init__(self, identifier, **kwargs):
+        Obj.__init__(self, **kwargs)
+        self.identifier = identifier
+
+
+def is_definition(obj):
+    return isinstance(obj, Definition)
+
+
+def fingerprint(obj, **kwargs):
+    return compute_fingerprint(obj, is_boundary=is_definition, **kwargs)[0]
+
+
+class FingerprintTest(unittest.TestCase):
+    def test_contents(self):
+        base = Definition('A', x=1, y=['a', 'b'], z={'k': 1.5})
+        self.assertEqual(
+            fingerprint(base),
+            fingerprint(Definition('A', y=['a', 'b'], z={'k': 1.5}, x=1)))
+        self.assertNotEqual(
+            fingerprint(base),
+            fingerprint(Definition('A', x=2, y=['a', 'b'], z={'k': 1.5})))
+        self.assertNotEqual(
+            fingerprint(base),
+            fingerprint(Definition('A', x=1, y=['b', 'a'], z={'k': 1.5})))
+        self.assertNotEqual(
+            fingerprint(base),
+            fingerprint(Definition('A', x=1, y=['a', 'b'], z={'k': 2.5})))
+        # Identifier is distinguished from str.
+        self.assertNotEqual(
+            fingerprint(base),
+            fingerprint(Definition(Identifier('A'), x=1, y=['a', 'b'],
+                                   z={'k': 1.5})))
+
+    def test_references(self):
+        b = Definition('B', value=1)
+        a = Definition('A', member=Obj(idl_type=Obj(definition=b)))
+        result, references = compute_fingerprint(a, is_boundary=is_definition)
+        self.assertEqual(set(['B']), references)
+
+        # The contents of referenced definitions do not matter, but what is
+        # referenced does.
+        b.value = 2
+        self.assertEqual(result, fingerprint(a))
+        a.member.idl_type.definition = Definition('C', value=1)
+        self.assertNotEqual(result, fingerprint(a))
+
+    def test_cycles(self):
+        a = Definition('A')
+        a.member = Obj(owner=a)
+        a.member.self_ref = a.member
+        a.list = [a.member, a.member]
+        result, references = compute_fingerprint(a, is_boundary=is_definition)
+        self.assertEqual(set(), references)
+
+        other = Definition('A')
+        other.member = Obj(owner=other)
+        other.member.self_ref = other.member
+        other.list = [other.member, Obj(owner=other, self_ref=None)]
+        self.assertNotEqual(result, fingerprint(other))
+
+    def test_sets(self):
+        self.assertEqual(
+            fingerprint(Definition('A', names=set(['x', 'y', 'z']))),
+            fingerprint(Definition('A', names=set(['z', 'y', 'x']))))
+        self.assertNotEqual(
+            fingerprint(Definition('A', names=set(['x', 'y']))),
+            fingerprint(Definition('A', names=set(['x', 'y', 'z']))))
+
+    def test_ignored_attributes(self):
+        a = Definition('A', member=Obj(value=1, position=10))
+        b = Definition('A', member=Obj(value=1, position=20))
+        self.assertNotEqual(fingerprint(a), fingerprint(b))
+        ignored_attributes = [(Obj, 'position')]
+        self.assertEqual(
+            fingerprint(a, ignored_attributes=ignored_attributes),
+            fingerprint(b, ignored_attributes=ignored_attributes))
@@ -126,6 +126,9 @@ class IdlCompiler(object):
         # Build observable array API objects.
         self._create_public_observable_arrays()
 
+        # Fingerprint the finalized API objects.
+        self._db.compute_fingerprints()
+
         return Database(self._db)
 
     def _maybe_make_copy(self, ir):